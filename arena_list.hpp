@@ -0,0 +1,645 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Fixed-capacity variant of List whose nodes live in one contiguous slab.
+// Links are 32-bit slot indices paired with a 32-bit ABA tag, so every link
+// fits a single 64-bit word and the protocol needs only plain CAS. Because
+// links are slab-relative the whole structure is relocatable. Insert/Remove
+// follow the same lock-by-null-link protocol as List::Node.
+template<typename T>
+class ArenaList
+{
+    using Index = std::uint32_t;
+
+    static constexpr Index kNil      = std::numeric_limits<Index>::max();
+    static constexpr Index kSentinel = 0;
+
+    struct Link
+    {
+        Index         idx;
+        std::uint32_t tag;
+    };
+
+    static_assert(sizeof(Link) == sizeof(std::uint64_t));
+    static_assert(std::atomic<Link>::is_always_lock_free);
+
+    struct Node
+    {
+        T&
+        data()
+        {
+            return *std::launder(reinterpret_cast<T*>(m_storage));
+        }
+
+        std::atomic<Link>          m_next{Link{kNil, 0}};
+        std::atomic<Link>          m_prev{Link{kNil, 0}};
+        std::atomic<std::uint32_t> m_refCounter{0};
+        std::atomic<bool>          m_removed{false};
+        alignas(T) unsigned char   m_storage[sizeof(T)];
+    };
+
+public:
+    using size_type = std::size_t;
+
+    class iterator
+    {
+    public:
+        iterator() = default;
+
+        ~iterator()
+        {
+            Reset();
+        }
+
+        iterator(const iterator& that)
+            : m_list(that.m_list)
+            , m_idx(that.m_idx)
+        {
+            if (m_list)
+                m_list->IncRef(m_idx);
+        }
+
+        iterator(iterator&& that) noexcept
+            : m_list(std::exchange(that.m_list, nullptr))
+            , m_idx(std::exchange(that.m_idx, kNil))
+        {
+        }
+
+        iterator&
+        operator=(const iterator& that)
+        {
+            if (this != &that)
+            {
+                if (that.m_list)
+                    that.m_list->IncRef(that.m_idx);
+                Reset();
+                m_list = that.m_list;
+                m_idx  = that.m_idx;
+            }
+            return *this;
+        }
+
+        iterator&
+        operator=(iterator&& that) noexcept
+        {
+            if (this != &that)
+            {
+                Reset();
+                m_list = std::exchange(that.m_list, nullptr);
+                m_idx  = std::exchange(that.m_idx, kNil);
+            }
+            return *this;
+        }
+
+        iterator&
+        operator++()
+        {
+            if (m_list)
+                Step(m_list->WaitNext(m_idx));
+            return *this;
+        }
+
+        iterator&
+        operator--()
+        {
+            if (m_list)
+                Step(m_list->WaitPrev(m_idx));
+            return *this;
+        }
+
+        T&
+        operator*() const
+        {
+            return m_list->m_nodes[m_idx].data();
+        }
+
+        T*
+        operator->() const
+        {
+            return &m_list->m_nodes[m_idx].data();
+        }
+
+        bool
+        operator==(const iterator& it) const
+        {
+            return m_idx == it.m_idx;
+        }
+
+        bool
+        operator!=(const iterator& it) const
+        {
+            return m_idx != it.m_idx;
+        }
+
+    private:
+        // takes over a reference the caller already holds
+        iterator(ArenaList* list, Index idx)
+            : m_list(list)
+            , m_idx(idx)
+        {
+        }
+
+        void
+        Step(Index idx)
+        {
+            const Index old = std::exchange(m_idx, idx);
+            m_list->DecRef(old);
+        }
+
+        void
+        Reset()
+        {
+            if (m_list)
+                m_list->DecRef(m_idx);
+            m_list = nullptr;
+            m_idx  = kNil;
+        }
+
+        ArenaList* m_list = nullptr;
+        Index      m_idx  = kNil;
+
+        friend class ArenaList;
+    };
+
+    explicit ArenaList(size_type capacity)
+        : m_capacity(capacity)
+        , m_nodes(std::make_unique<Node[]>(capacity + 1))
+    {
+        if (capacity >= kNil)
+            throw std::length_error("ArenaList capacity exceeds 32-bit index space");
+
+        Node& sentinel = m_nodes[kSentinel];
+        sentinel.m_refCounter.store(1, std::memory_order_relaxed);
+        sentinel.m_next.store(Link{kSentinel, 0}, std::memory_order_relaxed);
+        sentinel.m_prev.store(Link{kSentinel, 0}, std::memory_order_relaxed);
+
+        // thread every slot onto the free stack through its m_next link
+        for (Index i = 1; i <= capacity; ++i)
+            m_nodes[i].m_next.store(Link{i < capacity ? i + 1 : kNil, 0}, std::memory_order_relaxed);
+        m_free.store(Link{capacity ? Index{1} : kNil, 0}, std::memory_order_release);
+    }
+
+    ~ArenaList()
+    {
+        clear();
+    }
+
+    ArenaList(const ArenaList&) = delete;
+    ArenaList&
+    operator=(const ArenaList&) = delete;
+
+    iterator
+    begin()
+    {
+        return iterator(this, WaitNext(kSentinel));
+    }
+
+    iterator
+    end()
+    {
+        return Pin(kSentinel);
+    }
+
+    iterator
+    rbegin()
+    {
+        return iterator(this, WaitPrev(kSentinel));
+    }
+
+    iterator
+    rend()
+    {
+        return Pin(kSentinel);
+    }
+
+    T&
+    front()
+    {
+        auto it = begin();
+        if (it == end())
+            throw std::out_of_range("front() called on empty list");
+        return *it;
+    }
+
+    T&
+    back()
+    {
+        auto it = rbegin();
+        if (it == end())
+            throw std::out_of_range("back() called on empty list");
+        return *it;
+    }
+
+    // The new element is pinned before it is linked: once linked it can be
+    // popped and its slot freed before the push returns.
+    template<typename U>
+    iterator
+    push_front(U&& data)
+    {
+        const Index idx = Acquire(std::forward<U>(data));
+        iterator    it  = Pin(idx);
+        while (!Insert(begin().m_idx, idx))
+            ;
+        return it;
+    }
+
+    template<typename U>
+    iterator
+    push_back(U&& data)
+    {
+        const Index idx = Acquire(std::forward<U>(data));
+        iterator    it  = Pin(idx);
+        while (!Insert(kSentinel, idx))
+            ;
+        return it;
+    }
+
+    iterator
+    pop_front()
+    {
+        for (;;)
+        {
+            auto it = begin();
+            if (it == end() || Remove(it.m_idx).first)
+                return it;
+        }
+    }
+
+    iterator
+    pop_back()
+    {
+        for (;;)
+        {
+            auto it = rbegin();
+            if (it == end() || Remove(it.m_idx).first)
+                return it;
+        }
+    }
+
+    // Returns the element behind the erased one, or end() if it was erased
+    // concurrently.
+    iterator
+    erase(iterator it)
+    {
+        if (it == end())
+            return it;
+        return Remove(it.m_idx).second;
+    }
+
+    void
+    clear()
+    {
+        auto it = begin();
+        while (it != end())
+            it = erase(it);
+    }
+
+    bool
+    empty() const
+    {
+        return m_nodes[kSentinel].m_next.load(std::memory_order_acquire).idx == kSentinel;
+    }
+
+    size_type
+    size() const
+    {
+        return m_size.load(std::memory_order_acquire);
+    }
+
+    size_type
+    capacity() const
+    {
+        return m_capacity;
+    }
+
+    // Copies the elements in list order. It is a plain iteration and pins
+    // every node it steps onto: a slot can be recycled as soon as nothing
+    // holds it, so an unpinned index could be read after reuse.
+    std::vector<T>
+    snapshot()
+    {
+        std::vector<T> out;
+        out.reserve(size());
+        for (auto it = begin(); it != end(); ++it)
+            out.push_back(*it);
+        return out;
+    }
+
+private:
+    template<typename U>
+    Index
+    Acquire(U&& data)
+    {
+        Link head = m_free.load(std::memory_order_acquire);
+        for (;;)
+        {
+            if (head.idx == kNil)
+                throw std::bad_alloc();
+
+            const Index next = m_nodes[head.idx].m_next.load(std::memory_order_acquire).idx;
+            if (m_free.compare_exchange_weak(
+                    head, Link{next, head.tag + 1}, std::memory_order_acq_rel, std::memory_order_acquire))
+                break;
+        }
+
+        Node& node = m_nodes[head.idx];
+        ::new (static_cast<void*>(node.m_storage)) T(std::forward<U>(data));
+        node.m_removed.store(false, std::memory_order_relaxed);
+        node.m_refCounter.store(1, std::memory_order_release);
+        return head.idx;
+    }
+
+    void
+    Release(Index idx)
+    {
+        Node& node = m_nodes[idx];
+        node.data().~T();
+
+        Link head = m_free.load(std::memory_order_acquire);
+        for (;;)
+        {
+            Link link = node.m_next.load(std::memory_order_relaxed);
+            node.m_next.store(Link{head.idx, link.tag + 1}, std::memory_order_release);
+            if (m_free.compare_exchange_weak(
+                    head, Link{idx, head.tag + 1}, std::memory_order_acq_rel, std::memory_order_acquire))
+                return;
+        }
+    }
+
+    // The sentinel is never freed and keeps no count.
+    void
+    IncRef(Index idx)
+    {
+        if (idx != kSentinel)
+            m_nodes[idx].m_refCounter.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    // For indices read from a link: a slot whose count reached zero is on
+    // the free stack and must not be revived.
+    bool
+    TryIncRef(Index idx)
+    {
+        if (idx == kSentinel)
+            return true;
+
+        std::uint32_t count = m_nodes[idx].m_refCounter.load(std::memory_order_relaxed);
+        while (count != 0)
+        {
+            if (m_nodes[idx].m_refCounter.compare_exchange_weak(
+                    count, count + 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+    void
+    DecRef(Index idx)
+    {
+        if (idx != kSentinel && m_nodes[idx].m_refCounter.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            Release(idx);
+    }
+
+    iterator
+    Pin(Index idx)
+    {
+        IncRef(idx);
+        return iterator(this, idx);
+    }
+
+    Index
+    WaitNext(Index idx)
+    {
+        return PinLink(idx, &Node::m_next);
+    }
+
+    Index
+    WaitPrev(Index idx)
+    {
+        return PinLink(idx, &Node::m_prev);
+    }
+
+    // Pins the neighbour the pinned node `idx` links to. The slot may have
+    // been freed and reused since the link was read, so the count only
+    // counts once the link reads the same again, tag included: the node
+    // was linked all along and its neighbour could not be freed. A removed
+    // node's links are stale and the walk ends at the sentinel.
+    Index
+    PinLink(Index idx, std::atomic<Link> Node::*link)
+    {
+        Node& node = m_nodes[idx];
+        for (;;)
+        {
+            const Link l = (node.*link).load(std::memory_order_acquire);
+            if (l.idx == kNil)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            // Remove() marks the node before it unlocks its links, so a link
+            // read unlocked from an unmarked node was read while it was linked
+            if (node.m_removed.load(std::memory_order_acquire))
+                return kSentinel;
+
+            if (TryIncRef(l.idx))
+            {
+                const Link again = (node.*link).load(std::memory_order_acquire);
+                if (again.idx == l.idx && again.tag == l.tag)
+                    return l.idx;
+                DecRef(l.idx);
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    bool
+    IsLinked(Index self, Index next, Index prev) const
+    {
+        const Index nextThis = m_nodes[next].m_prev.load(std::memory_order_acquire).idx;
+        const Index prevThis = m_nodes[prev].m_next.load(std::memory_order_acquire).idx;
+        return (nextThis == kNil || nextThis == self) && (prevThis == kNil || prevThis == self);
+    }
+
+    // Links `idx` in front of `at`; false when `at` was removed concurrently.
+    bool
+    Insert(Index at, Index idx)
+    {
+        Node& self    = m_nodes[at];
+        Node& newNode = m_nodes[idx];
+        for (;;)
+        {
+            Link prevL = self.m_prev.load(std::memory_order_acquire);
+            if (prevL.idx == kNil)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            Link nextL = self.m_next.load(std::memory_order_acquire);
+            while (nextL.idx == kNil)
+            {
+                std::this_thread::yield();
+                nextL = self.m_next.load(std::memory_order_acquire);
+            }
+
+            if (self.m_removed.load(std::memory_order_acquire))
+                return false;
+
+            if (!IsLinked(at, nextL.idx, prevL.idx))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            Link expectedPrev = prevL;
+            Link lockPrev{kNil, expectedPrev.tag + 1};
+            if (!self.m_prev.compare_exchange_weak(
+                    expectedPrev, lockPrev, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                continue;
+            }
+
+            // recycled slots keep counting their tags up
+            newNode.m_prev.store(
+                Link{prevL.idx, newNode.m_prev.load(std::memory_order_relaxed).tag + 1}, std::memory_order_release);
+            newNode.m_next.store(
+                Link{at, newNode.m_next.load(std::memory_order_relaxed).tag + 1}, std::memory_order_release);
+
+            Node& prev     = m_nodes[prevL.idx];
+            Link  prevNext = prev.m_next.load(std::memory_order_acquire);
+            if (prevNext.idx != at || !prev.m_next.compare_exchange_strong(
+                                          prevNext,
+                                          Link{idx, prevNext.tag + 1},
+                                          std::memory_order_acq_rel,
+                                          std::memory_order_acquire))
+            {
+                self.m_prev.store(Link{prevL.idx, lockPrev.tag + 1}, std::memory_order_release);
+                std::this_thread::yield();
+                continue;
+            }
+
+            self.m_prev.store(Link{idx, lockPrev.tag + 1}, std::memory_order_release);
+            m_size.fetch_add(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+
+    // Returns whether this call removed the node, and then the successor it
+    // had, pinned; end() if someone else removed it.
+    std::pair<bool, iterator>
+    Remove(Index idx)
+    {
+        Node& self = m_nodes[idx];
+        for (;;)
+        {
+            Link nextL = self.m_next.load(std::memory_order_acquire);
+            if (nextL.idx == kNil)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            if (self.m_removed.load(std::memory_order_acquire))
+                return std::make_pair(false, end());
+
+            Link prevL = self.m_prev.load(std::memory_order_acquire);
+            if (prevL.idx == kNil)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            if (!IsLinked(idx, nextL.idx, prevL.idx))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            Link expectedNext = nextL;
+            Link lockNext{kNil, expectedNext.tag + 1};
+            if (!self.m_next.compare_exchange_weak(
+                    expectedNext, lockNext, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            Link expectedPrev = prevL;
+            Link lockPrev{kNil, expectedPrev.tag + 1};
+            if (!self.m_prev.compare_exchange_weak(
+                    expectedPrev, lockPrev, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                self.m_next.store(Link{nextL.idx, lockNext.tag + 1}, std::memory_order_release);
+                std::this_thread::yield();
+                continue;
+            }
+
+            // the successor is pinned for the caller before its m_prev is
+            // swung; the swing succeeding shows it was still linked here
+            Node&      next     = m_nodes[nextL.idx];
+            Link       nextPrev = next.m_prev.load(std::memory_order_acquire);
+            const bool pinned   = nextPrev.idx == idx && TryIncRef(nextL.idx);
+            if (!pinned || !next.m_prev.compare_exchange_strong(
+                               nextPrev,
+                               Link{prevL.idx, nextPrev.tag + 1},
+                               std::memory_order_acq_rel,
+                               std::memory_order_acquire))
+            {
+                if (pinned)
+                    DecRef(nextL.idx);
+                self.m_next.store(Link{nextL.idx, lockNext.tag + 1}, std::memory_order_release);
+                self.m_prev.store(Link{prevL.idx, lockPrev.tag + 1}, std::memory_order_release);
+                std::this_thread::yield();
+                continue;
+            }
+
+            Node& prev     = m_nodes[prevL.idx];
+            Link  prevNext = prev.m_next.load(std::memory_order_acquire);
+            for (;;)
+            {
+                if (prevNext.idx == kNil)
+                {
+                    std::this_thread::yield();
+                    prevNext = prev.m_next.load(std::memory_order_acquire);
+                    continue;
+                }
+
+                if (prevNext.idx != idx)
+                    break;
+
+                if (prev.m_next.compare_exchange_weak(
+                        prevNext,
+                        Link{nextL.idx, prevNext.tag + 1},
+                        std::memory_order_acq_rel,
+                        std::memory_order_acquire))
+                {
+                    break;
+                }
+
+                std::this_thread::yield();
+            }
+
+            self.m_removed.store(true, std::memory_order_release);
+            self.m_next.store(Link{nextL.idx, lockNext.tag + 1}, std::memory_order_release);
+            self.m_prev.store(Link{prevL.idx, lockPrev.tag + 1}, std::memory_order_release);
+            m_size.fetch_sub(1, std::memory_order_acq_rel);
+            DecRef(idx);
+
+            return std::make_pair(true, iterator(this, nextL.idx));
+        }
+    }
+
+    const size_type         m_capacity;
+    std::unique_ptr<Node[]> m_nodes;
+    std::atomic<Link>       m_free{Link{kNil, 0}};
+    std::atomic<size_type>  m_size{0};
+};
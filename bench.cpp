@@ -0,0 +1,610 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "concurrent_lru_cache.hpp"
+#include "lockfree_list.hpp"
+#include "numa_list.hpp"
+#include "perf_counters.hpp"
+#include "work_stealing_list.hpp"
+
+namespace
+{
+struct Options
+{
+    int  threads  = 0;
+    int  ops      = 200000;
+    bool counters = false;
+};
+
+struct Scenario
+{
+    const char*                          name;
+    std::function<void(List<int>&)>      prepare;
+    std::function<void(List<int>&, int)> run;
+};
+
+const char*
+ModeName(ExecutionMode mode)
+{
+    return mode == ExecutionMode::FlatCombining ? "flat-combining" : "lock-free";
+}
+
+// Counters, when given, cover the workers only, not the preparation.
+double
+RunScenario(const Scenario& scenario, ExecutionMode mode, const Options& opts, PerfCounters* counters = nullptr)
+{
+    List<int> l(mode);
+    scenario.prepare(l);
+
+    const int                perThread = opts.ops / opts.threads;
+    std::vector<std::thread> th;
+    th.reserve(opts.threads);
+
+    if (counters)
+        counters->Start();
+    const auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < opts.threads; ++t)
+        th.emplace_back(scenario.run, std::ref(l), perThread);
+    for (auto& x : th)
+        x.join();
+    const auto stop = std::chrono::steady_clock::now();
+    if (counters)
+        counters->Stop();
+
+    const double seconds = std::chrono::duration<double>(stop - start).count();
+    return static_cast<double>(perThread) * opts.threads / seconds;
+}
+
+std::vector<Scenario>
+Scenarios()
+{
+    auto none = [](List<int>&)
+    {
+    };
+
+    auto fill = [](List<int>& l)
+    {
+        for (int i = 0; i < 10000; ++i)
+            l.push_back(i);
+    };
+
+    return {
+        {"iteration",
+         fill,
+         [](List<int>& l, int n)
+         {
+             long sum = 0;
+             for (int done = 0; done < n;)
+             {
+                 for (auto it = l.begin(); it != l.end() && done < n; ++it, ++done)
+                     sum += *it;
+             }
+             if (sum < 0)
+                 std::abort();
+         }},
+        {"head push/pop",
+         none,
+         [](List<int>& l, int n)
+         {
+             for (int i = 0; i < n; ++i)
+             {
+                 if (i % 2 == 0)
+                     l.push_front(i);
+                 else
+                     l.pop_front();
+             }
+         }},
+        {"tail push/pop",
+         none,
+         [](List<int>& l, int n)
+         {
+             for (int i = 0; i < n; ++i)
+             {
+                 if (i % 2 == 0)
+                     l.push_back(i);
+                 else
+                     l.pop_back();
+             }
+         }},
+        {"mixed",
+         fill,
+         [](List<int>& l, int n)
+         {
+             for (int i = 0; i < n; ++i)
+             {
+                 switch (i % 4)
+                 {
+                 case 0:
+                     l.push_back(i);
+                     break;
+                 case 1:
+                     l.pop_front();
+                     break;
+                 case 2:
+                     l.push_front(i);
+                     break;
+                 default:
+                     l.pop_back();
+                     break;
+                 }
+             }
+         }},
+    };
+}
+
+// A single List homed on node 0 that counts its remote operations the way
+// NumaList::stats() does: one for every access from a thread on another node.
+class HomedList
+{
+public:
+    explicit HomedList(NumaTopology topo)
+        : m_topo(std::move(topo))
+    {
+    }
+
+    void
+    push_back(int value)
+    {
+        Count();
+        m_list.push_back(value);
+    }
+
+    void
+    pop_front()
+    {
+        Count();
+        m_list.pop_front();
+    }
+
+    std::uint64_t
+    remoteOps() const
+    {
+        return m_remoteOps.load(std::memory_order_relaxed);
+    }
+
+private:
+    void
+    Count()
+    {
+        if (m_topo.CurrentNode() != 0)
+            m_remoteOps.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    NumaTopology               m_topo;
+    List<int>                  m_list;
+    std::atomic<std::uint64_t> m_remoteOps{0};
+};
+
+// Producer/consumer traffic on a simulated two-node layout: threads are bound
+// to alternating nodes. With a single List every operation from node 1 goes
+// to the sentinel homed on node 0; NumaList only crosses nodes when stealing.
+// Both count the remote operations they actually perform.
+void
+RunNumaComparison(const Options& opts)
+{
+    constexpr int kNodes    = 2;
+    const int     perThread = opts.ops / opts.threads;
+
+    auto worker = [perThread](auto& l, int t)
+    {
+        NumaTopology::BindThread(t % kNodes);
+        for (int i = 0; i < perThread; ++i)
+        {
+            if (i % 2 == 0)
+                l.push_back(i);
+            else
+                l.pop_front();
+        }
+        NumaTopology::BindThread(-1);
+    };
+
+    auto measure = [&opts](auto& l, auto& fn)
+    {
+        std::vector<std::thread> th;
+        const auto               start = std::chrono::steady_clock::now();
+        for (int t = 0; t < opts.threads; ++t)
+            th.emplace_back(
+                [&l, &fn, t]()
+                {
+                    fn(l, t);
+                });
+        for (auto& x : th)
+            x.join();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    HomedList    single(NumaTopology::Simulated(kNodes, 1));
+    const double singleSec = measure(single, worker);
+
+    NumaList<int> numa(NumaTopology::Simulated(kNodes, 1));
+    const double  numaSec = measure(numa, worker);
+    const auto    stats   = numa.stats();
+
+    const double total = static_cast<double>(perThread) * opts.threads;
+    std::cout << "\nsimulated " << kNodes << "-node layout, push_back/pop_front\n";
+    std::cout << std::left << std::setw(16) << "list" << std::right << std::setw(14) << "ops/sec" << std::setw(16)
+              << "remote ops" << "\n";
+    std::cout << std::left << std::setw(16) << "List" << std::right << std::setw(14) << std::fixed
+              << std::setprecision(0) << total / singleSec << std::setw(16) << single.remoteOps() << "\n";
+    std::cout << std::left << std::setw(16) << "NumaList" << std::right << std::setw(14) << total / numaSec
+              << std::setw(16) << stats.remoteOps << "\n";
+}
+
+// The baseline the cache replaces: one mutex around std::list + index.
+class MutexLruCache
+{
+public:
+    explicit MutexLruCache(std::size_t capacity)
+        : m_capacity(capacity)
+    {
+    }
+
+    std::optional<int>
+    get(int key)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto                        found = m_index.find(key);
+        if (found == m_index.end())
+            return std::nullopt;
+        m_order.splice(m_order.begin(), m_order, found->second);
+        return found->second->second;
+    }
+
+    void
+    put(int key, int value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (auto found = m_index.find(key); found != m_index.end())
+            m_order.erase(found->second);
+        m_order.emplace_front(key, value);
+        m_index[key] = m_order.begin();
+        if (m_order.size() > m_capacity)
+        {
+            m_index.erase(m_order.back().first);
+            m_order.pop_back();
+        }
+    }
+
+private:
+    std::size_t                                                       m_capacity;
+    std::mutex                                                        m_mutex;
+    std::list<std::pair<int, int>>                                    m_order;
+    std::unordered_map<int, std::list<std::pair<int, int>>::iterator> m_index;
+};
+
+// Hit-only lookups over a preloaded key set; every 16th lookup is timed to
+// get a latency distribution without timing overhead on every call.
+template<typename Cache>
+void
+RunLruHits(const char* name, Cache& cache, const Options& opts)
+{
+    constexpr int kKeys = 4096;
+    for (int k = 0; k < kKeys; ++k)
+        cache.put(k, k);
+
+    const int                        perThread = opts.ops / opts.threads;
+    std::vector<std::vector<double>> samples(opts.threads);
+    std::vector<std::thread>         th;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < opts.threads; ++t)
+        th.emplace_back(
+            [&cache, &samples, perThread, t]()
+            {
+                std::mt19937 rng(t);
+                for (int i = 0; i < perThread; ++i)
+                {
+                    const int key = static_cast<int>(rng() % kKeys);
+                    if (i % 16 == 0)
+                    {
+                        const auto s = std::chrono::steady_clock::now();
+                        cache.get(key);
+                        samples[t].push_back(std::chrono::duration<double, std::nano>(
+                                                 std::chrono::steady_clock::now() - s)
+                                                 .count());
+                    }
+                    else
+                        cache.get(key);
+                }
+            });
+    for (auto& x : th)
+        x.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> all;
+    for (const auto& v : samples)
+        all.insert(all.end(), v.begin(), v.end());
+    std::sort(all.begin(), all.end());
+    const double p50 = all.empty() ? 0 : all[all.size() / 2];
+    const double p99 = all.empty() ? 0 : all[all.size() * 99 / 100];
+
+    std::cout << std::left << std::setw(24) << name << std::right << std::setw(14) << std::fixed
+              << std::setprecision(0) << static_cast<double>(perThread) * opts.threads / seconds << std::setw(10)
+              << p50 << std::setw(10) << p99 << "\n";
+}
+
+void
+RunLruComparison(const Options& opts)
+{
+    std::cout << "\nLRU cache hit path\n";
+    std::cout << std::left << std::setw(24) << "cache" << std::right << std::setw(14) << "gets/sec" << std::setw(10)
+              << "p50 ns" << std::setw(10) << "p99 ns" << "\n";
+
+    ConcurrentLruCache<int, int> lockFree(8192);
+    RunLruHits("ConcurrentLruCache", lockFree, opts);
+
+    MutexLruCache locked(8192);
+    RunLruHits("mutex list + map", locked, opts);
+}
+
+// Scheduler pattern: one owner pushes and pops at the back while the other
+// threads steal from the front. The List variant pays the full insert/remove
+// protocol on the owner side; WorkStealingList only synchronizes when the
+// ends meet.
+void
+RunWorkStealingComparison(const Options& opts)
+{
+    auto measure = [&opts](auto& l, auto steal)
+    {
+        std::atomic<bool>        done{false};
+        std::vector<std::thread> thieves;
+        for (int t = 1; t < opts.threads; ++t)
+            thieves.emplace_back(
+                [&]()
+                {
+                    while (!done.load(std::memory_order_relaxed))
+                        steal(l);
+                });
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < opts.ops; ++i)
+        {
+            l.push_back(i);
+            if (i % 2 == 1)
+                l.pop_back();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        done.store(true, std::memory_order_relaxed);
+        for (auto& x : thieves)
+            x.join();
+        return opts.ops / seconds;
+    };
+
+    List<int>    list;
+    const double listRate = measure(list,
+                                    [](List<int>& l)
+                                    {
+                                        l.pop_front();
+                                    });
+
+    WorkStealingList<int> deque;
+    const double          dequeRate = measure(deque,
+                                             [](WorkStealingList<int>& l)
+                                             {
+                                                 l.steal();
+                                             });
+
+    std::cout << "\nowner push_back/pop_back, " << opts.threads - 1 << " thieves\n";
+    std::cout << std::left << std::setw(20) << "list" << std::right << std::setw(14) << "owner ops/sec" << "\n";
+    std::cout << std::left << std::setw(20) << "List" << std::right << std::setw(14) << std::fixed
+              << std::setprecision(0) << listRate << "\n";
+    std::cout << std::left << std::setw(20) << "WorkStealingList" << std::right << std::setw(14) << dequeRate
+              << "\n";
+}
+
+// push_back/pop_front traffic with the thread layout each model allows, run
+// once with the specialized list and once with the MPMC default.
+template<Concurrency Model>
+double
+RunModel(int producers, int consumers, int ops)
+{
+    List<int, std::allocator<int>, Model> l;
+    const int                             perProducer = ops / producers;
+    const int                             total       = perProducer * producers;
+    std::atomic<int>                      popped{0};
+    std::vector<std::thread>              th;
+    th.reserve(producers + consumers);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int p = 0; p < producers; ++p)
+        th.emplace_back(
+            [&l, perProducer]()
+            {
+                for (int i = 0; i < perProducer; ++i)
+                    l.push_back(i);
+            });
+    for (int c = 0; c < consumers; ++c)
+        th.emplace_back(
+            [&l, &popped, total]()
+            {
+                while (popped.load(std::memory_order_relaxed) < total)
+                {
+                    if (l.pop_front() != l.end())
+                        popped.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+    for (auto& x : th)
+        x.join();
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return 2.0 * total / seconds;
+}
+
+template<Concurrency Model>
+void
+ReportModel(const char* name, int producers, int consumers, const Options& opts)
+{
+    const double rate     = RunModel<Model>(producers, consumers, opts.ops);
+    const double baseline = RunModel<Concurrency::MPMC>(producers, consumers, opts.ops);
+    std::cout << std::left << std::setw(8) << name << std::right << std::setw(6) << producers << std::setw(6)
+              << consumers << std::setw(14) << std::fixed << std::setprecision(0) << rate << std::setw(14) << baseline
+              << std::setw(10) << std::setprecision(2) << rate / baseline << std::endl;
+}
+
+void
+RunConcurrencyComparison(const Options& opts)
+{
+    const int many = std::max(2, opts.threads / 2);
+
+    std::cout << "\nconcurrency models, push_back/pop_front\n";
+    std::cout << std::left << std::setw(8) << "model" << std::right << std::setw(6) << "prod" << std::setw(6) << "cons"
+              << std::setw(14) << "ops/sec" << std::setw(14) << "MPMC ops/sec" << std::setw(10) << "speedup"
+              << "\n";
+    ReportModel<Concurrency::SPSC>("SPSC", 1, 1, opts);
+    ReportModel<Concurrency::MPSC>("MPSC", many, 1, opts);
+    ReportModel<Concurrency::SPMC>("SPMC", 1, many, opts);
+    ReportModel<Concurrency::MPMC>("MPMC", many, many, opts);
+}
+
+void
+RunProducerComparison(const Options& opts)
+{
+    auto measure = [&opts](auto push)
+    {
+        List<int>                list;
+        const int                perThread = opts.ops / opts.threads;
+        std::vector<std::thread> th;
+        const auto               start = std::chrono::steady_clock::now();
+        for (int t = 0; t < opts.threads; ++t)
+            th.emplace_back([&list, &push, perThread]() { push(list, perThread); });
+        for (auto& x : th)
+            x.join();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return perThread * opts.threads / seconds;
+    };
+
+    std::cout << "\nconcurrent push_back, " << opts.threads << " producers\n";
+    std::cout << std::left << std::setw(20) << "path" << std::right << std::setw(14) << "ops/sec" << "\n";
+    std::cout << std::left << std::setw(20) << "push_back" << std::right << std::setw(14) << std::fixed
+              << std::setprecision(0)
+              << measure(
+                     [](List<int>& l, int n)
+                     {
+                         for (int i = 0; i < n; ++i)
+                             l.push_back(i);
+                     })
+              << "\n";
+    for (std::size_t batch : {16, 64, 256})
+    {
+        const std::string name = "producer(" + std::to_string(batch) + ")";
+        std::cout << std::left << std::setw(20) << name << std::right << std::setw(14)
+                  << measure(
+                         [batch](List<int>& l, int n)
+                         {
+                             auto p = l.producer(batch);
+                             for (int i = 0; i < n; ++i)
+                                 p.push_back(i);
+                         })
+                  << "\n";
+    }
+}
+
+// Per-operation counts after a scenario run, n/a for counters that could
+// not be opened or read.
+void
+PrintCounters(const PerfCounters& counters, const Options& opts)
+{
+    const double ops = static_cast<double>(opts.ops / opts.threads) * opts.threads;
+    for (int c = 0; c < PerfCounters::kCounters; ++c)
+    {
+        const std::optional<double> n = counters.Read(static_cast<PerfCounters::Counter>(c));
+        if (n)
+            std::cout << std::setw(10) << std::fixed << std::setprecision(2) << *n / ops;
+        else
+            std::cout << std::setw(10) << "n/a";
+    }
+}
+}  // namespace
+
+int
+main(int argc, char** argv)
+{
+    Options                  opts;
+    std::vector<const char*> positional;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::string_view(argv[i]) == "--counters")
+            opts.counters = true;
+        else
+            positional.push_back(argv[i]);
+    }
+    if (positional.size() > 0)
+        opts.threads = std::atoi(positional[0]);
+    if (positional.size() > 1)
+        opts.ops = std::atoi(positional[1]);
+    if (opts.threads <= 0)
+        opts.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    if (opts.counters)
+    {
+        const PerfCounters probe;
+        if (!probe.Available())
+        {
+            std::cout << "hardware counters unavailable (" << probe.Error() << ")\n";
+            opts.counters = false;
+        }
+    }
+
+    std::cout << "threads: " << opts.threads << ", ops: " << opts.ops << "\n\n";
+    std::cout << std::left << std::setw(16) << "scenario" << std::setw(16) << "mode" << std::right << std::setw(14)
+              << "ops/sec";
+    if (opts.counters)
+    {
+        std::cout << "    per op:";
+        for (int c = 0; c < PerfCounters::kCounters; ++c)
+            std::cout << std::setw(10) << PerfCounters::Name(static_cast<PerfCounters::Counter>(c));
+    }
+    std::cout << "\n";
+
+    for (const auto& scenario : Scenarios())
+    {
+        for (ExecutionMode mode : {ExecutionMode::LockFree, ExecutionMode::FlatCombining})
+        {
+            // fresh counters per run: the ones of a previous run still hold
+            // what its exited workers counted
+            std::unique_ptr<PerfCounters> counters;
+            if (opts.counters)
+                counters = std::make_unique<PerfCounters>();
+            const double rate = RunScenario(scenario, mode, opts, counters.get());
+            std::cout << std::left << std::setw(16) << scenario.name << std::setw(16) << ModeName(mode) << std::right
+                      << std::setw(14) << std::fixed << std::setprecision(0) << rate;
+            if (counters)
+            {
+                std::cout << std::setw(11) << "";
+                PrintCounters(*counters, opts);
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    RunNumaComparison(opts);
+    RunLruComparison(opts);
+    RunWorkStealingComparison(opts);
+    RunConcurrencyComparison(opts);
+    RunProducerComparison(opts);
+
+#ifdef LOCKFREE_LIST_TRACE
+    const char* tracePath = "lockfree_list_trace.json";
+    if (TraceLog::Instance().WriteChrome(tracePath))
+        std::cout << "\ntrace written to " << tracePath << "\n";
+#endif
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "lockfree_list.hpp"
+
+// LRU cache whose recency order is a List: the most recently used entry is
+// at the front and eviction pops from the back. Keys are found through a
+// sharded hash index that maps to the list node; a hit only takes its
+// shard's lock in shared mode and promotes with the lock-free
+// List::move_to_front, so hits on different keys never serialize.
+template<typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class ConcurrentLruCache
+{
+    struct Entry
+    {
+        K key;
+        V value;
+    };
+
+    using RecencyList = List<Entry>;
+    using Handle      = typename RecencyList::iterator;
+
+public:
+    using size_type = std::size_t;
+
+    explicit ConcurrentLruCache(size_type capacity, size_type shards = 16)
+        : m_capacity(capacity)
+        , m_shards(shards ? shards : 1)
+    {
+    }
+
+    ConcurrentLruCache(const ConcurrentLruCache&) = delete;
+    ConcurrentLruCache&
+    operator=(const ConcurrentLruCache&) = delete;
+
+    std::optional<V>
+    get(const K& key)
+    {
+        Handle h;
+        {
+            Shard&           shard = ShardFor(key);
+            std::shared_lock lock(shard.mutex);
+            auto             found = shard.index.find(key);
+            if (found == shard.index.end())
+                return std::nullopt;
+            h = found->second;
+        }
+
+        // the pinned node stays readable even if it is evicted right now
+        m_recency.move_to_front(h);
+        return h->value;
+    }
+
+    bool
+    contains(const K& key)
+    {
+        Shard&           shard = ShardFor(key);
+        std::shared_lock lock(shard.mutex);
+        return shard.index.find(key) != shard.index.end();
+    }
+
+    void
+    put(const K& key, V value)
+    {
+        Handle old;
+        {
+            Shard&           shard = ShardFor(key);
+            std::unique_lock lock(shard.mutex);
+            Handle           h     = m_recency.push_front(Entry{key, std::move(value)});
+            auto [pos, inserted]   = shard.index.try_emplace(key, h);
+            if (!inserted)
+                old = std::exchange(pos->second, std::move(h));
+        }
+
+        // A new entry takes back at most the one entry it added, so puts
+        // racing past the capacity do not each evict down to it. A replaced
+        // one leaves the size as it was, unless an eviction took the old
+        // entry first and the new one is extra after all.
+        if ((old == Handle() || !m_recency.extract(old)) && m_recency.size() > m_capacity)
+            EvictOne();
+    }
+
+    bool
+    erase(const K& key)
+    {
+        Handle h;
+        {
+            Shard&           shard = ShardFor(key);
+            std::unique_lock lock(shard.mutex);
+            auto             found = shard.index.find(key);
+            if (found == shard.index.end())
+                return false;
+            h = std::move(found->second);
+            shard.index.erase(found);
+        }
+
+        m_recency.erase(h);
+        return true;
+    }
+
+    size_type
+    size() const
+    {
+        return m_recency.size();
+    }
+
+    size_type
+    capacity() const
+    {
+        return m_capacity;
+    }
+
+private:
+    struct alignas(64) Shard
+    {
+        std::shared_mutex                             mutex;
+        std::unordered_map<K, Handle, Hash, KeyEqual> index;
+    };
+
+    Shard&
+    ShardFor(const K& key)
+    {
+        return m_shards[Hash{}(key) % m_shards.size()];
+    }
+
+    void
+    EvictOne()
+    {
+        Handle victim = m_recency.pop_back();
+        if (victim == m_recency.end())
+            return;
+
+        Shard&           shard = ShardFor(victim->key);
+        std::unique_lock lock(shard.mutex);
+        auto             found = shard.index.find(victim->key);
+        // the key may have been overwritten since; only drop our own node
+        if (found != shard.index.end() && found->second == victim)
+            shard.index.erase(found);
+    }
+
+    // the index is destroyed first so its handles are gone before the list
+    const size_type    m_capacity;
+    RecencyList        m_recency;
+    std::vector<Shard> m_shards;
+};
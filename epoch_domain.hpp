@@ -0,0 +1,330 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Process-wide epoch based reclamation. Code that follows raw pointers into
+// a shared structure does so inside a Guard, which announces the global
+// epoch the thread entered in. Objects retired in epoch e are only freed once
+// the global epoch has reached e + 2: by then every guard that could have
+// seen them has exited.
+//
+// Each thread collects what it retires in a batch of its own and hands a full
+// batch to the domain with a single CAS; the rest goes over when the thread
+// exits or calls Barrier() or CollectNow(). Where the kernel offers an
+// expedited membarrier(2), entering a guard needs no fence: the rare epoch
+// advance pays for it by fencing every running thread of the process.
+class EpochDomain
+{
+public:
+    // Intrusive header for retired objects; `reclaim` frees the object.
+    struct Retired
+    {
+        Retired*      retiredNext  = nullptr;
+        std::uint64_t retiredEpoch = 0;
+        void (*reclaim)(Retired*)  = nullptr;
+    };
+
+    class Guard
+    {
+    public:
+        Guard()
+        {
+            Instance().Enter();
+        }
+
+        ~Guard()
+        {
+            Instance().Exit();
+        }
+
+        Guard(const Guard&) = delete;
+        Guard&
+        operator=(const Guard&) = delete;
+    };
+
+    static EpochDomain&
+    Instance()
+    {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    ~EpochDomain()
+    {
+        Collect(true);
+        for (Record* r = m_records.load(std::memory_order_acquire); r;)
+            delete std::exchange(r, r->next);
+    }
+
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain&
+    operator=(const EpochDomain&) = delete;
+
+    void
+    Retire(Retired* obj, void (*reclaim)(Retired*))
+    {
+        Record& r         = Mine();
+        obj->reclaim      = reclaim;
+        obj->retiredEpoch = m_epoch.load(std::memory_order_acquire);
+        obj->retiredNext  = std::exchange(r.batch, obj);
+        if (!r.batchTail)
+            r.batchTail = obj;
+        if (++r.batched < kBatch)
+            return;
+
+        HandOver(r);
+        if (!Collecting())
+        {
+            // someone else collecting right now covers us
+            std::unique_lock<std::mutex> lock(m_collectMutex, std::try_to_lock);
+            if (lock.owns_lock())
+                Collect(false);
+        }
+    }
+
+    // Like Retire(), but past the thread's batch: a Barrier() or CollectNow()
+    // on any thread sees the object. For memory that another thread may be
+    // waiting for, or that must be back before its allocator goes away.
+    void
+    RetireShared(Retired* obj, void (*reclaim)(Retired*))
+    {
+        obj->reclaim      = reclaim;
+        obj->retiredEpoch = m_epoch.load(std::memory_order_acquire);
+        Push(obj, obj);
+    }
+
+    // Waits for every guard that is active now to exit, then frees all that
+    // was retired before the call. Inside a guard, or from a destructor run
+    // by a collection, that would wait on ourselves; there it only frees what
+    // is already old enough.
+    void
+    Barrier()
+    {
+        HandOver(Mine());
+        if (Collecting() || Mine().depth != 0)
+            return;
+
+        const std::uint64_t target = m_epoch.load(std::memory_order_acquire) + 2;
+        while (m_epoch.load(std::memory_order_acquire) < target)
+        {
+            if (!TryAdvance())
+                std::this_thread::yield();
+        }
+
+        // waits out a concurrent Collect that may hold some of our objects
+        std::lock_guard<std::mutex> lock(m_collectMutex);
+        Collect(false);
+    }
+
+    // Frees what the guards active now already allow, advancing the epoch as
+    // far as they let it, without waiting for any of them to exit. Cheap
+    // enough for an allocation path that ran dry; only a concurrent
+    // collection is waited out.
+    void
+    CollectNow()
+    {
+        HandOver(Mine());
+        if (Collecting())
+            return;
+
+        std::lock_guard<std::mutex> lock(m_collectMutex);
+        TryAdvance();
+        Collect(false);
+    }
+
+private:
+    static constexpr unsigned kBatch = 64;
+
+    struct alignas(64) Record
+    {
+        // (epoch << 1) | 1 while the owner is inside a guard, 0 otherwise
+        std::atomic<std::uint64_t> local{0};
+        std::atomic<bool>          inUse{true};
+        Record*                    next  = nullptr;
+        unsigned                   depth = 0;
+        // retired by the owner and not handed over yet; only it touches these
+        Retired*                   batch     = nullptr;
+        Retired*                   batchTail = nullptr;
+        unsigned                   batched   = 0;
+    };
+
+    // Hands the batch over and returns the record to the pool when its thread
+    // exits. The main thread's run before the domain itself is destroyed.
+    struct ThreadRecord
+    {
+        ~ThreadRecord()
+        {
+            if (!record)
+                return;
+            Instance().HandOver(*record);
+            record->inUse.store(false, std::memory_order_release);
+        }
+
+        Record* record = nullptr;
+    };
+
+    EpochDomain()
+    {
+#if defined(__linux__) && defined(__NR_membarrier)
+        const long commands = syscall(__NR_membarrier, MEMBARRIER_CMD_QUERY, 0, 0);
+        if (commands > 0 && (commands & MEMBARRIER_CMD_PRIVATE_EXPEDITED))
+            m_expedited = syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+#endif
+    }
+
+    static bool&
+    Collecting()
+    {
+        static thread_local bool collecting = false;
+        return collecting;
+    }
+
+    Record&
+    Mine()
+    {
+        static thread_local ThreadRecord mine;
+        if (!mine.record)
+            mine.record = Claim();
+        return *mine.record;
+    }
+
+    Record*
+    Claim()
+    {
+        for (Record* r = m_records.load(std::memory_order_acquire); r; r = r->next)
+        {
+            bool expected = false;
+            if (!r->inUse.load(std::memory_order_relaxed) &&
+                r->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                return r;
+        }
+
+        Record* r = new Record;
+        r->next   = m_records.load(std::memory_order_relaxed);
+        while (!m_records.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+        return r;
+    }
+
+    void
+    Enter()
+    {
+        Record& r = Mine();
+        if (r.depth++ == 0)
+        {
+            r.local.store((m_epoch.load(std::memory_order_relaxed) << 1) | 1, std::memory_order_relaxed);
+            if (m_expedited)
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+            else
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    void
+    Exit()
+    {
+        Record& r = Mine();
+        if (--r.depth == 0)
+            r.local.store(0, std::memory_order_release);
+    }
+
+    // Either a guard's announcement is visible below, or the guard reads the
+    // structure after the fence and so misses whatever was unlinked before.
+    void
+    HeavyFence()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+#if defined(__linux__) && defined(__NR_membarrier)
+        if (m_expedited)
+            syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+#endif
+    }
+
+    bool
+    TryAdvance()
+    {
+        HeavyFence();
+        std::uint64_t epoch = m_epoch.load(std::memory_order_acquire);
+        for (Record* r = m_records.load(std::memory_order_acquire); r; r = r->next)
+        {
+            const std::uint64_t local = r->local.load(std::memory_order_acquire);
+            if ((local & 1) && (local >> 1) != epoch)
+                return false;
+        }
+
+        return m_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel);
+    }
+
+    // Frees what is old enough and puts the rest back; `all` is only for
+    // process exit. Callers hold m_collectMutex.
+    void
+    Collect(bool all)
+    {
+        TryAdvance();
+        Retired* list = m_retired.exchange(nullptr, std::memory_order_acquire);
+        if (!list)
+            return;
+
+        const std::uint64_t epoch = m_epoch.load(std::memory_order_acquire);
+        Retired*            keep  = nullptr;
+        Retired*            tail  = nullptr;
+        Collecting()              = true;
+        while (list)
+        {
+            Retired* obj = std::exchange(list, list->retiredNext);
+            if (all || obj->retiredEpoch + 2 <= epoch)
+            {
+                obj->reclaim(obj);
+                continue;
+            }
+
+            obj->retiredNext = keep;
+            keep             = obj;
+            if (!tail)
+                tail = obj;
+        }
+        Collecting() = false;
+
+        if (keep)
+            Push(keep, tail);
+    }
+
+    // Pushes the chain first..last onto the shared list.
+    void
+    Push(Retired* first, Retired* last)
+    {
+        last->retiredNext = m_retired.load(std::memory_order_relaxed);
+        while (!m_retired.compare_exchange_weak(
+            last->retiredNext, first, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void
+    HandOver(Record& r)
+    {
+        if (!r.batch)
+            return;
+        Push(r.batch, r.batchTail);
+        r.batch     = nullptr;
+        r.batchTail = nullptr;
+        r.batched   = 0;
+    }
+
+    alignas(64) std::atomic<std::uint64_t> m_epoch{1};
+    bool                                   m_expedited = false;
+    alignas(64) std::atomic<Retired*> m_retired{nullptr};
+    std::atomic<Record*>              m_records{nullptr};
+    std::mutex                        m_collectMutex;
+};
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+#include "lockfree_list.hpp"
+
+// List whose elements expire a time-to-live after they were appended. As
+// long as TTLs are similar, appending keeps the list ordered by expiry and
+// expired elements collect at the front, where sweep() pops them in bounded
+// batches without looking at the rest of the list. A background sweeper
+// can run the batches on a timer, and pushes can each sweep a few. Until an
+// expired element is swept, iteration, for_each() and pop_front() skip it.
+// An element that expires before the ones in front of it is skipped like
+// any other but only swept once it reaches the front.
+template<typename T, typename Clock = std::chrono::steady_clock>
+class ExpiringList
+{
+    struct Entry
+    {
+        typename Clock::time_point expiry;
+        T                          value;
+    };
+
+    using EntryList = List<Entry>;
+
+public:
+    using size_type  = std::size_t;
+    using duration   = typename Clock::duration;
+    using time_point = typename Clock::time_point;
+
+    static constexpr size_type kDefaultBatch = 64;
+
+    // Walks the elements that had not expired when begin() was called.
+    class iterator
+    {
+    public:
+        iterator() = default;
+
+        iterator&
+        operator++()
+        {
+            ++m_it;
+            Skip();
+            return *this;
+        }
+
+        T&
+        operator*() const
+        {
+            return m_it->value;
+        }
+
+        T*
+        operator->() const
+        {
+            return &m_it->value;
+        }
+
+        time_point
+        expiry() const
+        {
+            return m_it->expiry;
+        }
+
+        bool
+        operator==(const iterator& that) const
+        {
+            return m_it == that.m_it;
+        }
+
+        bool
+        operator!=(const iterator& that) const
+        {
+            return m_it != that.m_it;
+        }
+
+    private:
+        iterator(typename EntryList::iterator it, typename EntryList::iterator end, time_point now)
+            : m_it(std::move(it))
+            , m_end(std::move(end))
+            , m_now(now)
+        {
+            Skip();
+        }
+
+        void
+        Skip()
+        {
+            while (m_it != m_end && m_it->expiry <= m_now)
+                ++m_it;
+        }
+
+        typename EntryList::iterator m_it;
+        typename EntryList::iterator m_end;
+        time_point                   m_now{};
+
+        friend class ExpiringList;
+    };
+
+    // `sweepOnPush` expired elements, at most, are popped by every push.
+    explicit ExpiringList(duration ttl, size_type sweepOnPush = 0)
+        : m_ttl(ttl)
+        , m_sweepOnPush(sweepOnPush)
+    {
+    }
+
+    ExpiringList(const ExpiringList&) = delete;
+    ExpiringList&
+    operator=(const ExpiringList&) = delete;
+
+    iterator
+    begin()
+    {
+        return iterator(m_list.begin(), m_list.end(), Clock::now());
+    }
+
+    iterator
+    end()
+    {
+        return iterator(m_list.end(), m_list.end(), time_point{});
+    }
+
+    void
+    push_back(const T& value)
+    {
+        Push(Entry{Clock::now() + m_ttl, value});
+    }
+
+    void
+    push_back(T&& value)
+    {
+        Push(Entry{Clock::now() + m_ttl, std::move(value)});
+    }
+
+    void
+    push_back(const T& value, duration ttl)
+    {
+        Push(Entry{Clock::now() + ttl, value});
+    }
+
+    void
+    push_back(T&& value, duration ttl)
+    {
+        Push(Entry{Clock::now() + ttl, std::move(value)});
+    }
+
+    // Pops the first unexpired element, dropping expired ones on the way.
+    // The value is copied out: iterators and for_each() calls that were on
+    // the element when it was popped may still be reading it.
+    std::optional<T>
+    pop_front()
+    {
+        const time_point now = Clock::now();
+        for (;;)
+        {
+            auto it = m_list.pop_front();
+            if (it == m_list.end())
+                return std::nullopt;
+            if (it->expiry > now)
+                return it->value;
+        }
+    }
+
+    template<typename Fn>
+    void
+    for_each(Fn fn)
+    {
+        const time_point now = Clock::now();
+        for (auto it = m_list.begin(); it != m_list.end(); ++it)
+            if (it->expiry > now)
+                fn(it->value);
+    }
+
+    // Pops up to `max` expired elements off the front and stops at the
+    // first one still alive. Returns how many it removed; concurrent
+    // sweepers share the work without removing anything twice.
+    size_type
+    sweep(size_type max = kDefaultBatch)
+    {
+        const time_point now   = Clock::now();
+        size_type        swept = 0;
+        while (swept < max)
+        {
+            auto it = m_list.begin();
+            if (it == m_list.end() || it->expiry > now)
+                break;
+            if (m_list.extract(it))
+                ++swept;
+        }
+        return swept;
+    }
+
+    // Sweeps every `interval` on a thread owned by the list, in batches of
+    // `batch` with a yield in between, until the front is alive again.
+    // Replaces a sweeper already running.
+    void
+    start_sweeper(std::chrono::milliseconds interval, size_type batch = kDefaultBatch)
+    {
+        stop_sweeper();
+        m_sweeper = std::jthread(
+            [this, interval, batch](std::stop_token stop)
+            {
+                std::unique_lock<std::mutex> lock(m_sweeperMutex);
+                for (;;)
+                {
+                    m_sweeperWake.wait_for(lock, stop, interval, []() { return false; });
+                    if (stop.stop_requested())
+                        return;
+
+                    lock.unlock();
+                    while (sweep(batch) == batch && !stop.stop_requested())
+                        std::this_thread::yield();
+                    lock.lock();
+                }
+            });
+    }
+
+    void
+    stop_sweeper()
+    {
+        m_sweeper = std::jthread();
+    }
+
+    // Includes expired elements not swept yet.
+    size_type
+    size() const
+    {
+        return m_list.size();
+    }
+
+    duration
+    ttl() const
+    {
+        return m_ttl;
+    }
+
+private:
+    void
+    Push(Entry&& entry)
+    {
+        m_list.push_back(std::move(entry));
+        if (m_sweepOnPush)
+            sweep(m_sweepOnPush);
+    }
+
+    EntryList       m_list;
+    const duration  m_ttl;
+    const size_type m_sweepOnPush;
+
+    std::mutex                  m_sweeperMutex;
+    std::condition_variable_any m_sweeperWake;
+    // last, so the sweeper stops before the list goes away
+    std::jthread m_sweeper;
+};
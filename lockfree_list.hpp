@@ -1,711 +1,3371 @@
-#pragma once
-
-#include <atomic>
-#include <thread>
-#include <utility>
-#include <functional>
-#include <stdexcept>
-
-template<typename T>
-class List
-{
-    struct Node;
-    using NodePtr = Node*;
-
-    struct Link
-    {
-        NodePtr       ptr;
-        std::uint64_t tag;
-    };
-
-    static_assert(std::is_trivially_copyable_v<Link>);
-
-    struct Node
-    {
-    private:
-        explicit Node(const T& d)
-            : data(d)
-        {
-        }
-
-        explicit Node(T&& d)
-            : data(std::move(d))
-        {
-        }
-
-        Node() = default;
-
-    public:
-        static NodePtr
-        Create()
-        {
-            return new Node;
-        }
-
-        static NodePtr
-        Create(const T& d)
-        {
-            return new Node(d);
-        }
-
-        static NodePtr
-        Create(T&& d)
-        {
-            return new Node(std::move(d));
-        }
-
-        bool
-        Insert(NodePtr const newNode)
-        {
-            for (;;)
-            {
-                Link prevL = m_prev.load(std::memory_order_acquire);
-                if (!prevL.ptr)
-                {
-                    std::this_thread::yield();
-                    continue;
-                }
-
-                Link nextL = m_next.load(std::memory_order_acquire);
-                while (!nextL.ptr)
-                {
-                    std::this_thread::yield();
-                    nextL = m_next.load(std::memory_order_acquire);
-                }
-
-                if (!IsLinked(nextL.ptr, prevL.ptr))
-                {
-                    std::this_thread::yield();
-                    continue;
-                }
-
-                Link expectedPrev = prevL;
-                Link lockPrev{nullptr, expectedPrev.tag + 1};
-                if (!m_prev.compare_exchange_weak(
-                        expectedPrev,
-                        lockPrev,
-                        std::memory_order_acq_rel,
-                        std::memory_order_acquire))
-                {
-                    continue;
-                }
-
-                newNode->m_prev.store(Link{prevL.ptr, 0}, std::memory_order_release);
-                newNode->m_next.store(Link{this, 0}, std::memory_order_release);
-
-                if (prevL.ptr)
-                {
-                    Link prevNext = prevL.ptr->m_next.load(std::memory_order_acquire);
-                    if (prevNext.ptr != this || !prevL.ptr->m_next.compare_exchange_strong(
-                                                    prevNext,
-                                                    Link{newNode, prevNext.tag + 1},
-                                                    std::memory_order_acq_rel,
-                                                    std::memory_order_acquire))
-                    {
-                        m_prev.store(Link{prevL.ptr, lockPrev.tag + 1}, std::memory_order_release);
-                        std::this_thread::yield();
-                        continue;
-                    }
-                }
-
-                m_refCounter.fetch_add(1, std::memory_order_acq_rel);
-                m_prev.store(Link{newNode, lockPrev.tag + 1}, std::memory_order_release);
-                return true;
-            }
-        }
-
-        std::pair<bool, NodePtr>
-        Remove()
-        {
-            for (;;)
-            {
-                Link nextL = m_next.load(std::memory_order_acquire);
-                if (!nextL.ptr)
-                {
-                    std::this_thread::yield();
-                    continue;
-                }
-
-                Link prevL = m_prev.load(std::memory_order_acquire);
-                if (!prevL.ptr)
-                {
-                    std::this_thread::yield();
-                    continue;
-                }
-
-                if (!IsLinked(nextL.ptr, prevL.ptr))
-                {
-                    std::this_thread::yield();
-                    continue;
-                }
-
-                Link expectedNext = nextL;
-                Link lockNext{nullptr, expectedNext.tag + 1};
-                if (!m_next.compare_exchange_weak(
-                        expectedNext,
-                        lockNext,
-                        std::memory_order_acq_rel,
-                        std::memory_order_acquire))
-                {
-                    std::this_thread::yield();
-                    continue;
-                }
-
-                Link expectedPrev = prevL;
-                Link lockPrev{nullptr, expectedPrev.tag + 1};
-                if (!m_prev.compare_exchange_weak(
-                        expectedPrev,
-                        lockPrev,
-                        std::memory_order_acq_rel,
-                        std::memory_order_acquire))
-                {
-                    m_next.store(Link{nextL.ptr, lockNext.tag + 1}, std::memory_order_release);
-                    std::this_thread::yield();
-                    continue;
-                }
-
-                if (nextL.ptr)
-                {
-                    if (Link nextPrev = nextL.ptr->m_prev.load(std::memory_order_acquire);
-                        nextPrev.ptr != this || !nextL.ptr->m_prev.compare_exchange_strong(
-                                                    nextPrev,
-                                                    Link{prevL.ptr, nextPrev.tag + 1},
-                                                    std::memory_order_acq_rel,
-                                                    std::memory_order_acquire))
-                    {
-                        m_next.store(Link{nextL.ptr, lockNext.tag + 1}, std::memory_order_release);
-                        m_prev.store(Link{prevL.ptr, lockPrev.tag + 1}, std::memory_order_release);
-                        std::this_thread::yield();
-                        continue;
-                    }
-                }
-
-                if (prevL.ptr)
-                {
-                    Link prevNext = prevL.ptr->m_next.load(std::memory_order_acquire);
-                    for (;;)
-                    {
-                        if (prevNext.ptr != this)
-                            break;
-
-                        if (Link desired{nextL.ptr, prevNext.tag + 1}; prevL.ptr->m_next.compare_exchange_weak(
-                                prevNext,
-                                desired,
-                                std::memory_order_acq_rel,
-                                std::memory_order_acquire))
-                        {
-                            break;
-                        }
-
-                        std::this_thread::yield();
-                    }
-                }
-
-                m_next.store(Link{nextL.ptr, lockNext.tag + 1}, std::memory_order_release);
-                m_prev.store(Link{prevL.ptr, lockPrev.tag + 1}, std::memory_order_release);
-                m_refCounter.fetch_sub(1, std::memory_order_acq_rel);
-
-                return std::make_pair(true, nextL.ptr);
-            }
-        }
-
-        bool
-        IsLinked(const NodePtr next, const NodePtr prev) const
-        {
-            NodePtr    nextThis = next ? next->m_prev.load(std::memory_order_acquire).ptr : nullptr;
-            NodePtr    prevThis = prev ? prev->m_next.load(std::memory_order_acquire).ptr : nullptr;
-            const bool okNext   = (!next) || (!nextThis || nextThis == this);
-            const bool okPrev   = (!prev) || (!prevThis || prevThis == this);
-
-            return okNext && okPrev;
-        }
-
-        std::atomic<int>  m_refCounter{1};
-        std::atomic<Link> m_next{Link{nullptr, 0}};
-        std::atomic<Link> m_prev{Link{nullptr, 0}};
-        T                 data;
-    };
-
-    static void
-    DecRef(std::atomic<NodePtr>& node)
-    {
-        NodePtr nodePtr = node.exchange(nullptr, std::memory_order_acq_rel);
-        DecRef(nodePtr);
-    }
-
-    static void
-    DecRef(NodePtr node)
-    {
-        if (node && node->m_refCounter.fetch_sub(1, std::memory_order_acq_rel) == 1)
-            delete node;
-    }
-
-    static void
-    IncRef(NodePtr node)
-    {
-        if (node)
-            node->m_refCounter.fetch_add(1, std::memory_order_acq_rel);
-    }
-
-    static NodePtr
-    WaitNext(NodePtr node)
-    {
-        if (!node)
-            return node;
-
-        Link l = node->m_next.load(std::memory_order_acquire);
-        while (!l.ptr)
-        {
-            std::this_thread::yield();
-            l = node->m_next.load(std::memory_order_acquire);
-        }
-
-        if (l.ptr)
-            l.ptr->m_refCounter.fetch_add(1, std::memory_order_acq_rel);
-
-        return l.ptr;
-    }
-
-    static NodePtr
-    WaitPrev(NodePtr node)
-    {
-        if (!node)
-            return node;
-
-        Link l = node->m_prev.load(std::memory_order_acquire);
-        while (!l.ptr)
-        {
-            std::this_thread::yield();
-            l = node->m_prev.load(std::memory_order_acquire);
-        }
-
-        if (l.ptr)
-            l.ptr->m_refCounter.fetch_add(1, std::memory_order_acq_rel);
-
-        return l.ptr;
-    }
-
-public:
-    using size_type = std::size_t;
-
-    class iterator
-    {
-    public:
-        iterator() = default;
-
-        ~iterator()
-        {
-            NodePtr ptr = m_ptr.exchange(nullptr, std::memory_order_acq_rel);
-            DecRef(ptr);
-        }
-
-        iterator(const iterator& that)
-        {
-            NodePtr ptr = that.m_ptr.load(std::memory_order_acquire);
-            IncRef(ptr);
-            m_ptr.store(ptr, std::memory_order_release);
-        }
-
-        iterator(iterator&& that) noexcept
-        {
-            NodePtr ptr = that.m_ptr.exchange(nullptr, std::memory_order_acq_rel);
-            m_ptr.store(ptr, std::memory_order_release);
-        }
-
-        iterator&
-        operator=(const iterator& that)
-        {
-            if (this != &that)
-            {
-                NodePtr thatPtr = that.m_ptr.load(std::memory_order_acquire);
-                IncRef(thatPtr);
-                NodePtr oldPtr = m_ptr.exchange(thatPtr, std::memory_order_acq_rel);
-                DecRef(oldPtr);
-            }
-            return *this;
-        }
-
-        iterator&
-        operator=(iterator&& that) noexcept
-        {
-            if (this != &that)
-            {
-                NodePtr thatPtr = that.m_ptr.exchange(nullptr, std::memory_order_acq_rel);
-                NodePtr oldPtr = m_ptr.exchange(thatPtr, std::memory_order_acq_rel);
-                DecRef(oldPtr);
-            }
-            return *this;
-        }
-
-        iterator&
-        operator++()
-        {
-            NodePtr ptr = m_ptr.load(std::memory_order_acquire);
-            if (!ptr)
-                return *this;
-            NodePtr nextPtr = WaitNext(ptr);
-            NodePtr oldPtr = m_ptr.exchange(nextPtr, std::memory_order_acq_rel);
-            DecRef(oldPtr);
-
-            return *this;
-        }
-
-        iterator
-        operator++(int)
-        {
-            NodePtr ptr = m_ptr.load(std::memory_order_acquire);
-            IncRef(ptr);
-            iterator it;
-            it.m_ptr.store(ptr, std::memory_order_release);
-            if (ptr)
-            {
-                NodePtr nextPtr = WaitNext(ptr);
-                NodePtr oldPtr = m_ptr.exchange(nextPtr, std::memory_order_acq_rel);
-                DecRef(oldPtr);
-            }
-            return it;
-        }
-
-        iterator&
-        operator--()
-        {
-            NodePtr ptr = m_ptr.load(std::memory_order_acquire);
-            if (!ptr)
-                return *this;
-            NodePtr prevPtr = WaitPrev(ptr);
-            NodePtr oldPtr = m_ptr.exchange(prevPtr, std::memory_order_acq_rel);
-            DecRef(oldPtr);
-
-            return *this;
-        }
-
-        iterator
-        operator--(int)
-        {
-            NodePtr ptr = m_ptr.load(std::memory_order_acquire);
-            IncRef(ptr);
-            iterator it;
-            it.m_ptr.store(ptr, std::memory_order_release);
-            if (ptr)
-            {
-                NodePtr prevPtr = WaitPrev(ptr);
-                NodePtr oldPtr = m_ptr.exchange(prevPtr, std::memory_order_acq_rel);
-                DecRef(oldPtr);
-            }
-            return it;
-        }
-
-        T&
-        operator*() const
-        {
-            NodePtr ptr = m_ptr.load(std::memory_order_acquire);
-            return ptr->data;
-        }
-
-        T*
-        operator->() const
-        {
-            NodePtr ptr = m_ptr.load(std::memory_order_acquire);
-            return &(ptr->data);
-        }
-
-        bool
-        operator==(const iterator& it) const
-        {
-            return m_ptr.load(std::memory_order_acquire) == it.m_ptr.load(std::memory_order_acquire);
-        }
-
-        bool
-        operator!=(const iterator& it) const
-        {
-            return m_ptr.load(std::memory_order_acquire) != it.m_ptr.load(std::memory_order_acquire);
-        }
-
-    private:
-        explicit iterator(NodePtr ptr)
-            : m_ptr(ptr)
-        {
-            IncRef(ptr);
-        }
-
-        NodePtr
-        handle() const
-        {
-            return m_ptr.load(std::memory_order_acquire);
-        }
-
-        mutable std::atomic<NodePtr> m_ptr = nullptr;
-
-        friend class List<T>;
-    };
-
-    List()
-        : m_last(Node::Create())
-        , m_size(0)
-    {
-        if (!m_last)
-            throw std::bad_alloc();
-        m_last->m_prev.store(Link{m_last, 0}, std::memory_order_release);
-        m_last->m_next.store(Link{m_last, 0}, std::memory_order_release);
-    }
-
-    ~List()
-    {
-        clear();
-        delete m_last;
-    }
-
-    List(const List&) = delete;
-    List&
-    operator=(const List&) = delete;
-    List(List&&)           = delete;
-    List&
-    operator=(List&&) = delete;
-
-    iterator
-    begin()
-    {
-        return iterator(m_last->m_next.load(std::memory_order_acquire).ptr);
-    }
-
-    T&
-    front()
-    {
-        auto it = begin();
-        if (it == end())
-            throw std::out_of_range("front() called on empty list");
-        return *it;
-    }
-
-    T&
-    back()
-    {
-        auto it = rbegin();
-        if (it == end())
-            throw std::out_of_range("back() called on empty list");
-        return *it;
-    }
-
-    const iterator
-    cbegin() const
-    {
-        return iterator(m_last->m_next.load(std::memory_order_acquire).ptr);
-    }
-
-    const iterator
-    cend() const
-    {
-        return iterator(m_last);
-    }
-
-    iterator
-    end()
-    {
-        return iterator(m_last);
-    }
-
-    iterator
-    rbegin()
-    {
-        return iterator(m_last->m_prev.load(std::memory_order_acquire).ptr);
-    }
-
-    iterator
-    rend()
-    {
-        return iterator(m_last);
-    }
-
-    iterator
-    pop_front()
-    {
-        for (;;)
-        {
-            auto it = begin();
-            if (it != end())
-            {
-                if (Erase(it).first)
-                    return it;
-            }
-            else
-                return it;
-        }
-    }
-
-    iterator
-    pop_back()
-    {
-        for (;;)
-        {
-            auto it = rbegin();
-            if (it != end())
-            {
-                if (Erase(it).first)
-                    return it;
-            }
-            else
-                return it;
-        }
-    }
-
-    iterator
-    push_front(const T& data)
-    {
-        iterator      it;
-        const NodePtr newNode = Node::Create(data);
-        if (!newNode)
-            throw std::bad_alloc();
-        do
-        {
-            it = Insert(begin(), newNode);
-        } while (it == end());
-
-        return it;
-    }
-
-    iterator
-    push_front(T&& data)
-    {
-        iterator      it;
-        const NodePtr newNode = Node::Create(std::move(data));
-        if (!newNode)
-            throw std::bad_alloc();
-        do
-        {
-            it = Insert(begin(), newNode);
-        } while (it == end());
-
-        return it;
-    }
-
-    iterator
-    push_back(const T& data)
-    {
-        iterator      it;
-        const NodePtr newNode = Node::Create(data);
-        if (!newNode)
-            throw std::bad_alloc();
-        do
-        {
-            it = Insert(end(), newNode);
-        } while (it == end());
-
-        return it;
-    }
-
-    iterator
-    push_back(T&& data)
-    {
-        iterator      it;
-        const NodePtr newNode = Node::Create(std::move(data));
-        if (!newNode)
-            throw std::bad_alloc();
-        do
-        {
-            it = Insert(end(), newNode);
-        } while (it == end());
-
-        return it;
-    }
-
-    iterator
-    emplace_back(const T& data)
-    {
-        return push_back(data);
-    }
-
-    iterator
-    emplace_back(T&& data)
-    {
-        return push_back(std::move(data));
-    }
-
-    iterator
-    erase(iterator it)
-    {
-        if (it == end())
-            return it;
-        return Erase(it).second;
-    }
-
-    void
-    clear()
-    {
-        auto it = begin();
-        while (it != end())
-            it = erase(it);
-    }
-
-    bool
-    empty() const
-    {
-        return cbegin() == cend();
-    }
-
-    size_type
-    size() const
-    {
-        return m_size.load(std::memory_order_acquire);
-    }
-
-    // this method isn't thread-safe
-    template<typename Compare = std::less<T>>
-    void
-    sort(Compare comp = std::less<T>())
-    {
-        const size_t s = m_size.load(std::memory_order_acquire);
-        if (s > 1)
-        {
-            for (size_t i = 0; i < s - 1; i++)
-            {
-                auto iter1 = begin();
-                auto iter2 = iter1;
-                ++iter2;
-                bool shouldBreak = true;
-                for (size_t j = 0; j < s - i - 1; j++, ++iter1, ++iter2)
-                {
-                    NodePtr item1 = iter1.m_ptr.load(std::memory_order_acquire);
-                    NodePtr item2 = iter2.m_ptr.load(std::memory_order_acquire);
-                    if (comp(item2->data, item1->data))
-                    {
-                        std::swap(item1->data, item2->data);
-                        shouldBreak = false;
-                    }
-                }
-
-                if (shouldBreak)
-                    break;
-            }
-        }
-    }
-
-private:
-    iterator
-    Insert(const iterator it, NodePtr node)
-    {
-        NodePtr h = it.handle();
-        if (h && h->Insert(node))
-        {
-            m_size.fetch_add(1, std::memory_order_acq_rel);
-            return iterator(node);
-        }
-
-        return end();
-    }
-
-    std::pair<bool, iterator>
-    Erase(iterator it)
-    {
-        NodePtr h = it.handle();
-        if (!h)
-            return std::make_pair(false, end());
-        std::pair<bool, NodePtr> res = h->Remove();
-        if (res.first)
-            m_size.fetch_sub(1, std::memory_order_acq_rel);
-
-        return std::make_pair(res.first, iterator(res.second));
-    }
-
-    NodePtr             m_last;
-    std::atomic<size_t> m_size;
-};
\ No newline at end of file
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <typeinfo>
+#include <utility>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <source_location>
+#include <span>
+#include <vector>
+
+#include "epoch_domain.hpp"
+#include "node_accounting.hpp"
+#include "node_pool.hpp"
+#include "trace_ring.hpp"
+
+// LockFree runs every operation through the node link protocol directly.
+// FlatCombining routes push/pop at the ends through per-thread publication
+// slots that a single combiner thread applies in one pass; it gives up
+// lock-freedom for those operations in exchange for far less contention on
+// the sentinel under high thread counts.
+enum class ExecutionMode
+{
+    LockFree,
+    FlatCombining
+};
+
+// Which threads may mutate the list. Producers call push_*/emplace_*;
+// consumers call pop_*, erase, clear and everything else that removes or
+// moves elements. A single-threaded side keeps its counter with plain loads
+// and stores instead of read-modify-write instructions, and a single
+// consumer pops the end node straight off the sentinel: it cannot lose that
+// node to anyone, so it skips the pinning walk and the retry loop. The node
+// link protocol itself is shared by every model because producers and the
+// consumer still meet on the sentinel links, and iteration and erase in the
+// middle depend on it.
+enum class Concurrency
+{
+    SPSC,
+    MPSC,
+    SPMC,
+    MPMC
+};
+
+template<typename T, typename Allocator = std::allocator<T>, Concurrency Model = Concurrency::MPMC>
+class List
+{
+    struct Node;
+    using NodePtr       = Node*;
+    using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using NodeTraits    = std::allocator_traits<NodeAllocator>;
+
+    struct Link
+    {
+        NodePtr       ptr;
+        std::uint64_t tag;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Link>);
+
+    // The top bits of a tag carry the link state. A locked link belongs to
+    // an Insert/Remove in progress but still holds a valid pointer; a marked
+    // m_next means the node has been unlinked. A marked link that is also
+    // swapped leads to the node that replaced this one rather than to its
+    // successor.
+    static constexpr std::uint64_t kLockBit  = std::uint64_t{1} << 63;
+    static constexpr std::uint64_t kMarkBit  = std::uint64_t{1} << 62;
+    static constexpr std::uint64_t kSwapBit  = std::uint64_t{1} << 61;
+    static constexpr std::uint64_t kFlagMask = kLockBit | kMarkBit | kSwapBit;
+
+    static bool
+    IsLocked(const Link& l)
+    {
+        return l.tag & kLockBit;
+    }
+
+    static bool
+    IsMarked(const Link& l)
+    {
+        return l.tag & kMarkBit;
+    }
+
+    static bool
+    IsSwapped(const Link& l)
+    {
+        return l.tag & kSwapBit;
+    }
+
+    static std::uint64_t
+    NextTag(const Link& l)
+    {
+        return ((l.tag & ~kFlagMask) + 1) & ~kFlagMask;
+    }
+
+    // Trace points compile to nothing unless LOCKFREE_LIST_TRACE is defined;
+    // the call site's line tells retries of different CASes apart.
+    static void
+    Trace([[maybe_unused]] TraceEvent event,
+          [[maybe_unused]] const void* node,
+          [[maybe_unused]] std::source_location where = std::source_location::current())
+    {
+#ifdef LOCKFREE_LIST_TRACE
+        TraceLog::Record(event, node, where.line());
+#endif
+    }
+
+    static void
+    Yield(const void* node, std::source_location where = std::source_location::current())
+    {
+        Trace(TraceEvent::Yield, node, where);
+        std::this_thread::yield();
+    }
+
+    // Brackets one Insert or Remove call in the trace.
+    class TraceOp
+    {
+    public:
+        TraceOp(TraceEvent begin, const void* node)
+            : m_end(static_cast<TraceEvent>(static_cast<int>(begin) + 1))
+            , m_node(node)
+        {
+            Trace(begin, node);
+        }
+
+        ~TraceOp()
+        {
+            Trace(m_end, m_node);
+        }
+
+        TraceOp(const TraceOp&) = delete;
+        TraceOp&
+        operator=(const TraceOp&) = delete;
+
+    private:
+        const TraceEvent  m_end;
+        const void* const m_node;
+    };
+
+    struct Node : EpochDomain::Retired
+    {
+    private:
+        template<typename... Args>
+        explicit Node(const NodeAllocator& alloc, Args&&... args)
+            : m_alloc(alloc)
+            , data(std::forward<Args>(args)...)
+        {
+        }
+
+    public:
+        template<typename... Args>
+        static NodePtr
+        Create(NodeAllocator alloc, Args&&... args)
+        {
+            NodePtr node = NodeTraits::allocate(alloc, 1);
+            try
+            {
+                ::new (static_cast<void*>(node)) Node(alloc, std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                NodeTraits::deallocate(alloc, node, 1);
+                throw;
+            }
+
+            node->reclaim = &Reclaim<false>;
+            return node;
+        }
+
+        template<typename... Args>
+        static NodePtr
+        Create(NodePool& pool, NodeAllocator alloc, Args&&... args)
+        {
+            void* slot = pool.Acquire();
+            try
+            {
+                NodePtr node = ::new (slot) Node(alloc, std::forward<Args>(args)...);
+                node->reclaim = &Reclaim<true>;
+                return node;
+            }
+            catch (...)
+            {
+                pool.Release(slot);
+                throw;
+            }
+        }
+
+        // the node carries its own allocator copy, so whichever thread drops
+        // the last reference can free it without going through the list
+        static void
+        Destroy(NodePtr node)
+        {
+            if (node->Pooled())
+            {
+                NodePool& pool = NodePool::Owner(node);
+                node->~Node();
+                pool.Release(node);
+                return;
+            }
+
+            NodeAllocator alloc(std::move(node->m_alloc));
+            node->~Node();
+            NodeTraits::deallocate(alloc, node, 1);
+        }
+
+        bool
+        Insert(NodePtr const newNode)
+        {
+            return Insert(newNode, newNode);
+        }
+
+        // Links the chain first..last, already linked internally, in front
+        // of this node with a single CAS on the predecessor's m_next. A
+        // relocated last node's m_next stays locked until it is linked, which
+        // keeps it reading as removed until it reappears. Given an
+        // `owner`, fails when this node belongs to another list; our locked
+        // m_prev keeps it from moving while that is checked.
+        bool
+        Insert(NodePtr const first, NodePtr const last, NodePtr const owner = nullptr)
+        {
+            EpochDomain::Guard guard;
+            TraceOp            op(TraceEvent::InsertBegin, this);
+            for (;;)
+            {
+                Link nextL = m_next.load(std::memory_order_acquire);
+                // the insertion point was removed under us; the caller has to
+                // pick a new one
+                if (IsMarked(nextL))
+                    return false;
+
+                if (IsLocked(nextL))
+                {
+                    Yield(this);
+                    continue;
+                }
+
+                Link prevL = m_prev.load(std::memory_order_acquire);
+                if (IsLocked(prevL))
+                {
+                    Yield(this);
+                    continue;
+                }
+
+                if (!IsLinked(nextL.ptr, prevL.ptr))
+                {
+                    Yield(this);
+                    continue;
+                }
+
+                // the predecessor is being removed or replaced and needs our
+                // m_prev; taking it now would only make that wait for our
+                // retries
+                if (IsLocked(prevL.ptr->m_next.load(std::memory_order_acquire)))
+                {
+                    Yield(prevL.ptr);
+                    continue;
+                }
+
+                Link expectedPrev = prevL;
+                Link lockPrev{prevL.ptr, NextTag(prevL) | kLockBit};
+                if (!m_prev.compare_exchange_weak(
+                        expectedPrev,
+                        lockPrev,
+                        std::memory_order_acq_rel,
+                        std::memory_order_acquire))
+                {
+                    Trace(TraceEvent::CasFail, this);
+                    continue;
+                }
+                Trace(TraceEvent::LockPrev, this);
+
+                if (owner && m_owner.load(std::memory_order_relaxed) != owner)
+                {
+                    m_prev.store(Link{prevL.ptr, NextTag(lockPrev)}, std::memory_order_release);
+                    Trace(TraceEvent::UnlockPrev, this);
+                    return false;
+                }
+
+                first->m_owner.store(m_owner.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                last->m_owner.store(m_owner.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+                // a relinked node keeps counting its tags up; a fresh one is
+                // unreachable until the CAS below and needs no lock
+                const Link newNext = last->m_next.load(std::memory_order_relaxed);
+                const bool fresh   = !newNext.ptr;
+                const Link lockNew{this, NextTag(newNext) | (newNext.tag & kMarkBit) | (fresh ? 0 : kLockBit)};
+                first->m_prev.store(
+                    Link{prevL.ptr, NextTag(first->m_prev.load(std::memory_order_relaxed))},
+                    std::memory_order_release);
+                last->m_next.store(lockNew, std::memory_order_release);
+
+                Link prevNext = prevL.ptr->m_next.load(std::memory_order_acquire);
+                if (prevNext.ptr != this || prevNext.tag & kFlagMask ||
+                    !prevL.ptr->m_next.compare_exchange_strong(
+                        prevNext,
+                        Link{first, NextTag(prevNext)},
+                        std::memory_order_acq_rel,
+                        std::memory_order_acquire))
+                {
+                    Trace(TraceEvent::CasFail, prevL.ptr);
+                    m_prev.store(Link{prevL.ptr, NextTag(lockPrev)}, std::memory_order_release);
+                    Trace(TraceEvent::UnlockPrev, this);
+                    Yield(this);
+                    continue;
+                }
+
+                if (!fresh)
+                    last->m_next.store(Link{this, NextTag(lockNew)}, std::memory_order_release);
+                m_prev.store(Link{last, NextTag(lockPrev)}, std::memory_order_release);
+                Trace(TraceEvent::UnlockPrev, this);
+                return true;
+            }
+        }
+
+        // Locks both own links, bypasses the node from both neighbours and
+        // marks m_next. Locks keep the pointer they cover, so readers walk
+        // through a node under removal instead of waiting for it; the mark
+        // is set as soon as the successor no longer points back, at which
+        // point the removal can only complete. With both links locked the
+        // node cannot move, so that is where it is checked to still belong
+        // to `owner`'s list. With `relink` the node is being moved: m_next
+        // stays locked and the list's reference stays with the node, so a
+        // concurrent Remove waits for Insert to link it again instead of
+        // losing to the move.
+        std::pair<bool, NodePtr>
+        Remove(NodePtr owner, bool relink = false)
+        {
+            EpochDomain::Guard guard;
+            TraceOp            op(TraceEvent::RemoveBegin, this);
+            for (;;)
+            {
+                Link nextL = m_next.load(std::memory_order_acquire);
+                if (IsLocked(nextL))
+                {
+                    Yield(this);
+                    continue;
+                }
+
+                // lost the race against another Remove of this node
+                if (IsMarked(nextL))
+                    return std::make_pair(false, nextL.ptr);
+
+                Link prevL = m_prev.load(std::memory_order_acquire);
+                if (IsLocked(prevL))
+                {
+                    Yield(this);
+                    continue;
+                }
+
+                if (!IsLinked(nextL.ptr, prevL.ptr))
+                {
+                    Yield(this);
+                    continue;
+                }
+
+                // the successor is being removed, replaced or inserted in
+                // front of and has to swing our m_next; locking it now would
+                // only make that wait for our retries
+                if (IsLocked(nextL.ptr->m_prev.load(std::memory_order_acquire)))
+                {
+                    Yield(nextL.ptr);
+                    continue;
+                }
+
+                Link expectedNext = nextL;
+                Link lockNext{nextL.ptr, NextTag(nextL) | kLockBit};
+                if (!m_next.compare_exchange_weak(
+                        expectedNext,
+                        lockNext,
+                        std::memory_order_acq_rel,
+                        std::memory_order_acquire))
+                {
+                    Trace(TraceEvent::CasFail, this);
+                    Yield(this);
+                    continue;
+                }
+                Trace(TraceEvent::LockNext, this);
+
+                Link expectedPrev = prevL;
+                Link lockPrev{prevL.ptr, NextTag(prevL) | kLockBit};
+                if (!m_prev.compare_exchange_weak(
+                        expectedPrev,
+                        lockPrev,
+                        std::memory_order_acq_rel,
+                        std::memory_order_acquire))
+                {
+                    Trace(TraceEvent::CasFail, this);
+                    m_next.store(Link{nextL.ptr, NextTag(lockNext)}, std::memory_order_release);
+                    Trace(TraceEvent::UnlockNext, this);
+                    Yield(this);
+                    continue;
+                }
+                Trace(TraceEvent::LockPrev, this);
+
+                if (m_owner.load(std::memory_order_relaxed) != owner)
+                {
+                    m_next.store(Link{nextL.ptr, NextTag(lockNext)}, std::memory_order_release);
+                    m_prev.store(Link{prevL.ptr, NextTag(lockPrev)}, std::memory_order_release);
+                    Trace(TraceEvent::UnlockNext, this);
+                    Trace(TraceEvent::UnlockPrev, this);
+                    return std::make_pair(false, nextL.ptr);
+                }
+
+                if (Link nextPrev = nextL.ptr->m_prev.load(std::memory_order_acquire);
+                    nextPrev.ptr != this || IsLocked(nextPrev) ||
+                    !nextL.ptr->m_prev.compare_exchange_strong(
+                        nextPrev,
+                        Link{prevL.ptr, NextTag(nextPrev)},
+                        std::memory_order_acq_rel,
+                        std::memory_order_acquire))
+                {
+                    Trace(TraceEvent::CasFail, nextL.ptr);
+                    m_next.store(Link{nextL.ptr, NextTag(lockNext)}, std::memory_order_release);
+                    m_prev.store(Link{prevL.ptr, NextTag(lockPrev)}, std::memory_order_release);
+                    Trace(TraceEvent::UnlockNext, this);
+                    Trace(TraceEvent::UnlockPrev, this);
+                    Yield(this);
+                    continue;
+                }
+
+                // The marked link owns a reference on the successor, so an
+                // iterator parked here can always move on. The successor
+                // cannot finish its own removal before we swing prev->m_next.
+                IncRef(nextL.ptr);
+                lockNext = Link{nextL.ptr, NextTag(lockNext) | kLockBit | kMarkBit};
+                m_next.store(lockNext, std::memory_order_release);
+
+                Link prevNext = prevL.ptr->m_next.load(std::memory_order_acquire);
+                for (;;)
+                {
+                    // the predecessor is being removed itself; it will back
+                    // off once it sees our lock on m_prev
+                    if (IsLocked(prevNext))
+                    {
+                        Yield(prevL.ptr);
+                        prevNext = prevL.ptr->m_next.load(std::memory_order_acquire);
+                        continue;
+                    }
+
+                    // detached by clear(), which removes us along with it;
+                    // IsLinked leaves nothing else that could repoint it
+                    if (prevNext.ptr != this)
+                        break;
+
+                    // a predecessor marked by clear() owns a reference on us
+                    // that moves on to our successor with the link
+                    const bool marked = IsMarked(prevNext);
+                    if (marked)
+                        IncRef(nextL.ptr);
+                    if (Link desired{nextL.ptr, NextTag(prevNext) | (prevNext.tag & kMarkBit)};
+                        prevL.ptr->m_next.compare_exchange_weak(
+                            prevNext,
+                            desired,
+                            std::memory_order_acq_rel,
+                            std::memory_order_acquire))
+                    {
+                        if (marked)
+                            DecRef(this);
+                        break;
+                    }
+
+                    if (marked)
+                        DecRef(nextL.ptr);
+                    Trace(TraceEvent::CasFail, prevL.ptr);
+                    Yield(prevL.ptr);
+                }
+
+                m_prev.store(Link{prevL.ptr, NextTag(lockPrev)}, std::memory_order_release);
+                Trace(TraceEvent::UnlockPrev, this);
+                if (relink)
+                    return std::make_pair(true, nextL.ptr);
+
+                m_next.store(Link{nextL.ptr, NextTag(lockNext) | kMarkBit}, std::memory_order_release);
+                Trace(TraceEvent::UnlockNext, this);
+                DecRef(this);
+
+                return std::make_pair(true, nextL.ptr);
+            }
+        }
+
+        // Swaps `fresh` in for this node at its place. Both own links are
+        // locked as in Remove, then the successor's m_prev and the
+        // predecessor's m_next are swung over to `fresh`, and only then is
+        // m_next marked, as swapped and leading to `fresh`: a reader finds
+        // exactly one of the two in this place, whether it steps over the
+        // node or from it. Fails like Remove when the node is already gone
+        // or belongs elsewhere, and also when clear() detaches it meanwhile;
+        // `fresh` is then never linked.
+        bool
+        Replace(NodePtr owner, NodePtr fresh)
+        {
+            EpochDomain::Guard guard;
+            TraceOp            op(TraceEvent::ReplaceBegin, this);
+            for (;;)
+            {
+                Link nextL = m_next.load(std::memory_order_acquire);
+                if (IsLocked(nextL))
+                {
+                    Yield(this);
+                    continue;
+                }
+
+                if (IsMarked(nextL))
+                    return false;
+
+                Link prevL = m_prev.load(std::memory_order_acquire);
+                if (IsLocked(prevL))
+                {
+                    Yield(this);
+                    continue;
+                }
+
+                if (!IsLinked(nextL.ptr, prevL.ptr))
+                {
+                    Yield(this);
+                    continue;
+                }
+
+                // leave our m_next to a busy successor, as Remove does
+                if (IsLocked(nextL.ptr->m_prev.load(std::memory_order_acquire)))
+                {
+                    Yield(nextL.ptr);
+                    continue;
+                }
+
+                Link expectedNext = nextL;
+                Link lockNext{nextL.ptr, NextTag(nextL) | kLockBit};
+                if (!m_next.compare_exchange_weak(
+                        expectedNext,
+                        lockNext,
+                        std::memory_order_acq_rel,
+                        std::memory_order_acquire))
+                {
+                    Trace(TraceEvent::CasFail, this);
+                    Yield(this);
+                    continue;
+                }
+                Trace(TraceEvent::LockNext, this);
+
+                Link expectedPrev = prevL;
+                Link lockPrev{prevL.ptr, NextTag(prevL) | kLockBit};
+                if (!m_prev.compare_exchange_weak(
+                        expectedPrev,
+                        lockPrev,
+                        std::memory_order_acq_rel,
+                        std::memory_order_acquire))
+                {
+                    Trace(TraceEvent::CasFail, this);
+                    m_next.store(Link{nextL.ptr, NextTag(lockNext)}, std::memory_order_release);
+                    Trace(TraceEvent::UnlockNext, this);
+                    Yield(this);
+                    continue;
+                }
+                Trace(TraceEvent::LockPrev, this);
+
+                if (m_owner.load(std::memory_order_relaxed) != owner)
+                {
+                    m_next.store(Link{nextL.ptr, NextTag(lockNext)}, std::memory_order_release);
+                    m_prev.store(Link{prevL.ptr, NextTag(lockPrev)}, std::memory_order_release);
+                    Trace(TraceEvent::UnlockNext, this);
+                    Trace(TraceEvent::UnlockPrev, this);
+                    return false;
+                }
+
+                fresh->m_owner.store(owner, std::memory_order_relaxed);
+                fresh->m_prev.store(
+                    Link{prevL.ptr, NextTag(fresh->m_prev.load(std::memory_order_relaxed))},
+                    std::memory_order_release);
+                fresh->m_next.store(
+                    Link{nextL.ptr, NextTag(fresh->m_next.load(std::memory_order_relaxed))},
+                    std::memory_order_release);
+
+                // Once the successor points back at `fresh` it can be removed
+                // without waiting for us; the reference a plain marked link
+                // would own is taken while it still cannot.
+                IncRef(nextL.ptr);
+                if (Link nextPrev = nextL.ptr->m_prev.load(std::memory_order_acquire);
+                    nextPrev.ptr != this || IsLocked(nextPrev) ||
+                    !nextL.ptr->m_prev.compare_exchange_strong(
+                        nextPrev,
+                        Link{fresh, NextTag(nextPrev)},
+                        std::memory_order_acq_rel,
+                        std::memory_order_acquire))
+                {
+                    Trace(TraceEvent::CasFail, nextL.ptr);
+                    DecRef(nextL.ptr);
+                    m_next.store(Link{nextL.ptr, NextTag(lockNext)}, std::memory_order_release);
+                    m_prev.store(Link{prevL.ptr, NextTag(lockPrev)}, std::memory_order_release);
+                    Trace(TraceEvent::UnlockNext, this);
+                    Trace(TraceEvent::UnlockPrev, this);
+                    Yield(this);
+                    continue;
+                }
+
+                bool swapped  = false;
+                Link prevNext = prevL.ptr->m_next.load(std::memory_order_acquire);
+                for (;;)
+                {
+                    if (IsLocked(prevNext))
+                    {
+                        Yield(prevL.ptr);
+                        prevNext = prevL.ptr->m_next.load(std::memory_order_acquire);
+                        continue;
+                    }
+
+                    // detached by clear(), which removes us along with it
+                    if (prevNext.ptr != this)
+                        break;
+
+                    // a predecessor marked by clear() owns a reference on us
+                    // that moves on to `fresh` with the link
+                    const bool marked = IsMarked(prevNext);
+                    if (marked)
+                        IncRef(fresh);
+                    if (Link desired{fresh, NextTag(prevNext) | (prevNext.tag & kMarkBit)};
+                        prevL.ptr->m_next.compare_exchange_weak(
+                            prevNext,
+                            desired,
+                            std::memory_order_acq_rel,
+                            std::memory_order_acquire))
+                    {
+                        if (marked)
+                            DecRef(this);
+                        swapped = true;
+                        break;
+                    }
+
+                    if (marked)
+                        DecRef(fresh);
+                    Trace(TraceEvent::CasFail, prevL.ptr);
+                    Yield(prevL.ptr);
+                }
+
+                m_prev.store(Link{prevL.ptr, NextTag(lockPrev)}, std::memory_order_release);
+                if (swapped)
+                {
+                    IncRef(fresh);
+                    m_next.store(Link{fresh, NextTag(lockNext) | kMarkBit | kSwapBit}, std::memory_order_release);
+                    DecRef(nextL.ptr);
+                }
+                else
+                {
+                    m_next.store(Link{nextL.ptr, NextTag(lockNext) | kMarkBit}, std::memory_order_release);
+                }
+                Trace(TraceEvent::UnlockPrev, this);
+                Trace(TraceEvent::UnlockNext, this);
+                DecRef(this);
+
+                return swapped;
+            }
+        }
+
+        // Both neighbours have to point back at us, locked or not. A lock
+        // keeps its pointer, and a predecessor locked by a removal that backs
+        // off may still lead to a node being bypassed in front of us; taking
+        // that for linked would let us mark ourselves before that bypass
+        // swings the predecessor onto us, stranding our successor. Once our
+        // m_prev is locked on a predecessor that led to us, only our own swing
+        // or clear() can point it elsewhere.
+        bool
+        IsLinked(const NodePtr next, const NodePtr prev) const
+        {
+            const Link nextThis = next->m_prev.load(std::memory_order_acquire);
+            const Link prevThis = prev->m_next.load(std::memory_order_acquire);
+
+            return nextThis.ptr == this && prevThis.ptr == this && !IsMarked(prevThis);
+        }
+
+        bool
+        Removed() const
+        {
+            return IsMarked(m_next.load(std::memory_order_acquire));
+        }
+
+        // Where the node came from is kept in how it is reclaimed, set when
+        // it is created, and its pool in the slot header in front of it, so
+        // nodes pay nothing for reserve() whether they use it or not.
+        bool
+        Pooled() const
+        {
+            return reclaim == &Reclaim<true>;
+        }
+
+        std::atomic<int>  m_refCounter{1};
+        // last parallel scan that claimed the node; fills the padding
+        // behind the count
+        std::atomic<std::uint32_t> m_scan{0};
+        // list the node is charged to; none for sentinels
+        NodeAccounting*   m_accounting = nullptr;
+        // sentinel of the list the node was last linked into
+        std::atomic<NodePtr> m_owner{nullptr};
+        std::atomic<Link> m_next{Link{nullptr, 0}};
+        std::atomic<Link> m_prev{Link{nullptr, 0}};
+
+        [[no_unique_address]] NodeAllocator m_alloc;
+
+        T data;
+    };
+
+    static constexpr bool kSingleProducer = Model == Concurrency::SPSC || Model == Concurrency::SPMC;
+    static constexpr bool kSingleConsumer = Model == Concurrency::SPSC || Model == Concurrency::MPSC;
+    // retired nodes may wait in the retiring thread's batch; see DecRef()
+    static constexpr bool kBatchRetire = NodeTraits::is_always_equal::value;
+
+    // counters written by one side only; with a single writer there is
+    // nobody to race with and a plain store publishes the new value
+    template<bool SingleWriter>
+    static void
+    Bump(std::atomic<size_t>& counter, size_t n = 1)
+    {
+        if constexpr (SingleWriter)
+            counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_release);
+        else
+            counter.fetch_add(n, std::memory_order_acq_rel);
+    }
+
+    static void
+    DecRef(std::atomic<NodePtr>& node)
+    {
+        NodePtr nodePtr = node.exchange(nullptr, std::memory_order_acq_rel);
+        DecRef(nodePtr);
+    }
+
+    // The last reference retires the node; it is freed once no epoch guard
+    // can still see it. A marked m_next owns a reference on its target, which
+    // is dropped along with the node; chains are released iteratively.
+    // Pooled nodes and those of an allocator that may compare unequal go
+    // straight to the shared retire list, where a push waiting on the pool
+    // or the destructor's barrier finds them.
+    static void
+    DecRef(NodePtr node)
+    {
+        while (node && node->m_refCounter.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            const Link next = node->m_next.load(std::memory_order_acquire);
+            if (NodeAccounting* accounting = node->m_accounting)
+                accounting->CountRetired();
+            if (kBatchRetire && !node->Pooled())
+                EpochDomain::Instance().Retire(node, node->reclaim);
+            else
+                EpochDomain::Instance().RetireShared(node, node->reclaim);
+            node = IsMarked(next) ? next.ptr : nullptr;
+        }
+    }
+
+    // Instantiated once for pooled nodes and once for the others, which
+    // tells them apart; see Node::Pooled().
+    template<bool Pooled>
+    static void
+    Reclaim(EpochDomain::Retired* retired)
+    {
+        const NodePtr   node       = static_cast<NodePtr>(retired);
+        NodeAccounting* accounting = node->m_accounting;
+        Node::Destroy(node);
+        if (accounting)
+            accounting->CountFreed(true);
+    }
+
+    // only for nodes the caller already holds a reference on
+    static void
+    IncRef(NodePtr node)
+    {
+        if (node)
+            node->m_refCounter.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    // For pointers read from a link: a node whose count already reached zero
+    // is retired and must not be revived.
+    static bool
+    TryIncRef(NodePtr node)
+    {
+        int count = node->m_refCounter.load(std::memory_order_relaxed);
+        while (count != 0)
+        {
+            if (node->m_refCounter.compare_exchange_weak(
+                    count, count + 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+    // Pins the successor, stepping over nodes whose removal has committed.
+    // Never waits on a writer: locked links still carry their pointer.
+    // Retired nodes stay readable inside the guard and are stepped over too.
+    // A removed node's successor may since have been moved into another
+    // list; a live node then waits for its own link to be swung, while a
+    // removed one gives up and ends at its list's sentinel.
+    static NodePtr
+    StepNext(NodePtr node)
+    {
+        if (!node)
+            return node;
+
+        EpochDomain::Guard guard;
+        // A replaced node was already seen, so stepping from it continues
+        // behind its replacement; its link keeps the replacement alive. The
+        // link that ends the walk is the one stepped along.
+        auto successor = [&node]()
+        {
+            Link l = node->m_next.load(std::memory_order_acquire);
+            for (; IsSwapped(l); l = node->m_next.load(std::memory_order_acquire))
+                node = l.ptr;
+            return l.ptr;
+        };
+
+        NodePtr       next  = successor();
+        const NodePtr owner = node->m_owner.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            if (!TryIncRef(next))
+            {
+                next = next->m_next.load(std::memory_order_acquire).ptr;
+                continue;
+            }
+
+            if (next->m_owner.load(std::memory_order_relaxed) != owner)
+            {
+                DecRef(next);
+                next = successor();
+                if (node->Removed())
+                {
+                    IncRef(owner);
+                    return owner;
+                }
+
+                Yield(node);
+                continue;
+            }
+
+            if (!next->Removed())
+                return next;
+
+            NodePtr after = next->m_next.load(std::memory_order_acquire).ptr;
+            DecRef(next);
+            next = after;
+        }
+    }
+
+    // A removed node's m_prev owns no reference and may be stale, so
+    // stepping back from one restarts from its first live successor.
+    static NodePtr
+    StepPrev(NodePtr node)
+    {
+        if (!node)
+            return node;
+
+        EpochDomain::Guard guard;
+        while (!node->Removed())
+        {
+            NodePtr prev = node->m_prev.load(std::memory_order_acquire).ptr;
+            if (TryIncRef(prev))
+            {
+                if (!prev->Removed())
+                    return prev;
+                DecRef(prev);
+            }
+
+            // a remover swings our m_prev before it marks; clear() marks
+            // without swinging and reaches us next
+            Yield(node);
+        }
+
+        NodePtr anchor = StepNext(node);
+        NodePtr prev   = StepPrev(anchor);
+        DecRef(anchor);
+        return prev;
+    }
+
+public:
+    using size_type      = std::size_t;
+    using allocator_type = Allocator;
+
+    class iterator
+    {
+    public:
+        iterator() = default;
+
+        ~iterator()
+        {
+            NodePtr ptr = m_ptr.exchange(nullptr, std::memory_order_acq_rel);
+            DecRef(ptr);
+        }
+
+        iterator(const iterator& that)
+        {
+            NodePtr ptr = that.m_ptr.load(std::memory_order_acquire);
+            IncRef(ptr);
+            m_ptr.store(ptr, std::memory_order_release);
+        }
+
+        iterator(iterator&& that) noexcept
+        {
+            NodePtr ptr = that.m_ptr.exchange(nullptr, std::memory_order_acq_rel);
+            m_ptr.store(ptr, std::memory_order_release);
+        }
+
+        iterator&
+        operator=(const iterator& that)
+        {
+            if (this != &that)
+            {
+                NodePtr thatPtr = that.m_ptr.load(std::memory_order_acquire);
+                IncRef(thatPtr);
+                NodePtr oldPtr = m_ptr.exchange(thatPtr, std::memory_order_acq_rel);
+                DecRef(oldPtr);
+            }
+            return *this;
+        }
+
+        iterator&
+        operator=(iterator&& that) noexcept
+        {
+            if (this != &that)
+            {
+                NodePtr thatPtr = that.m_ptr.exchange(nullptr, std::memory_order_acq_rel);
+                NodePtr oldPtr = m_ptr.exchange(thatPtr, std::memory_order_acq_rel);
+                DecRef(oldPtr);
+            }
+            return *this;
+        }
+
+        iterator&
+        operator++()
+        {
+            NodePtr ptr = m_ptr.load(std::memory_order_acquire);
+            if (!ptr)
+                return *this;
+            NodePtr nextPtr = StepNext(ptr);
+            NodePtr oldPtr = m_ptr.exchange(nextPtr, std::memory_order_acq_rel);
+            DecRef(oldPtr);
+
+            return *this;
+        }
+
+        iterator
+        operator++(int)
+        {
+            NodePtr ptr = m_ptr.load(std::memory_order_acquire);
+            IncRef(ptr);
+            iterator it;
+            it.m_ptr.store(ptr, std::memory_order_release);
+            if (ptr)
+            {
+                NodePtr nextPtr = StepNext(ptr);
+                NodePtr oldPtr = m_ptr.exchange(nextPtr, std::memory_order_acq_rel);
+                DecRef(oldPtr);
+            }
+            return it;
+        }
+
+        iterator&
+        operator--()
+        {
+            NodePtr ptr = m_ptr.load(std::memory_order_acquire);
+            if (!ptr)
+                return *this;
+            NodePtr prevPtr = StepPrev(ptr);
+            NodePtr oldPtr = m_ptr.exchange(prevPtr, std::memory_order_acq_rel);
+            DecRef(oldPtr);
+
+            return *this;
+        }
+
+        iterator
+        operator--(int)
+        {
+            NodePtr ptr = m_ptr.load(std::memory_order_acquire);
+            IncRef(ptr);
+            iterator it;
+            it.m_ptr.store(ptr, std::memory_order_release);
+            if (ptr)
+            {
+                NodePtr prevPtr = StepPrev(ptr);
+                NodePtr oldPtr = m_ptr.exchange(prevPtr, std::memory_order_acq_rel);
+                DecRef(oldPtr);
+            }
+            return it;
+        }
+
+        T&
+        operator*() const
+        {
+            NodePtr ptr = m_ptr.load(std::memory_order_acquire);
+            return ptr->data;
+        }
+
+        T*
+        operator->() const
+        {
+            NodePtr ptr = m_ptr.load(std::memory_order_acquire);
+            return &(ptr->data);
+        }
+
+        bool
+        operator==(const iterator& it) const
+        {
+            return m_ptr.load(std::memory_order_acquire) == it.m_ptr.load(std::memory_order_acquire);
+        }
+
+        bool
+        operator!=(const iterator& it) const
+        {
+            return m_ptr.load(std::memory_order_acquire) != it.m_ptr.load(std::memory_order_acquire);
+        }
+
+    private:
+        explicit iterator(NodePtr ptr)
+            : m_ptr(ptr)
+        {
+            IncRef(ptr);
+        }
+
+        NodePtr
+        handle() const
+        {
+            return m_ptr.load(std::memory_order_acquire);
+        }
+
+        mutable std::atomic<NodePtr> m_ptr = nullptr;
+
+        friend class List;
+    };
+
+    // Owns an element taken out with extract() or pop_*_node(). It can be
+    // linked into any list of the same type with insert(), which reuses the
+    // node as is; dropping the handle frees it. Iterators still pinning the
+    // node keep reading it as removed until it is inserted again.
+    class node_handle
+    {
+    public:
+        node_handle() = default;
+
+        ~node_handle()
+        {
+            DecRef(m_node);
+        }
+
+        node_handle(node_handle&& that) noexcept
+            : m_node(std::exchange(that.m_node, nullptr))
+        {
+        }
+
+        node_handle&
+        operator=(node_handle&& that) noexcept
+        {
+            if (this != &that)
+                DecRef(std::exchange(m_node, std::exchange(that.m_node, nullptr)));
+            return *this;
+        }
+
+        node_handle(const node_handle&) = delete;
+        node_handle&
+        operator=(const node_handle&) = delete;
+
+        bool
+        empty() const
+        {
+            return !m_node;
+        }
+
+        explicit
+        operator bool() const
+        {
+            return m_node;
+        }
+
+        T&
+        value() const
+        {
+            return m_node->data;
+        }
+
+    private:
+        explicit node_handle(NodePtr node)
+            : m_node(node)
+        {
+        }
+
+        NodePtr m_node = nullptr;
+
+        friend class List;
+    };
+
+    // Buffers the pushes of one thread in a private chain and links it in
+    // at the back in one step once `batch` elements are pending, once the
+    // oldest pending element has waited `maxDelay`, or on flush(). The
+    // delay is only checked on push, so a producer going idle should
+    // flush(); destroying the handle flushes too. A handle must not outlive
+    // its list and is used by one thread at a time.
+    class Producer
+    {
+    public:
+        Producer(Producer&& that) noexcept
+            : m_list(that.m_list)
+            , m_head(std::exchange(that.m_head, nullptr))
+            , m_tail(std::exchange(that.m_tail, nullptr))
+            , m_count(std::exchange(that.m_count, 0))
+            , m_batch(that.m_batch)
+            , m_maxDelay(that.m_maxDelay)
+            , m_oldest(that.m_oldest)
+        {
+        }
+
+        Producer(const Producer&) = delete;
+        Producer&
+        operator=(const Producer&) = delete;
+        Producer&
+        operator=(Producer&&) = delete;
+
+        ~Producer()
+        {
+            flush();
+        }
+
+        void
+        push_back(const T& data)
+        {
+            Push(m_list->NewNode(data));
+        }
+
+        void
+        push_back(T&& data)
+        {
+            Push(m_list->NewNode(std::move(data)));
+        }
+
+        template<typename... Args>
+        void
+        emplace_back(Args&&... args)
+        {
+            Push(m_list->NewNode(std::forward<Args>(args)...));
+        }
+
+        // Publishes everything pending; the elements become visible at once
+        // and in push order.
+        void
+        flush()
+        {
+            if (!m_head)
+                return;
+
+            m_list->InsertBefore(m_list->end(), m_head, m_tail, m_count);
+            m_head  = nullptr;
+            m_tail  = nullptr;
+            m_count = 0;
+        }
+
+        size_type
+        pending() const
+        {
+            return m_count;
+        }
+
+    private:
+        Producer(List& list, size_type batch, std::chrono::microseconds maxDelay)
+            : m_list(&list)
+            , m_batch(std::max<size_type>(batch, 1))
+            , m_maxDelay(maxDelay)
+        {
+        }
+
+        void
+        Push(NodePtr node)
+        {
+            if (!node)
+                throw std::bad_alloc();
+
+            const auto now = std::chrono::steady_clock::now();
+            if (!m_head)
+                m_oldest = now;
+            m_list->Append(m_head, m_tail, node);
+            if (++m_count >= m_batch || now - m_oldest >= m_maxDelay)
+                flush();
+        }
+
+        List*                                 m_list;
+        NodePtr                               m_head  = nullptr;
+        NodePtr                               m_tail  = nullptr;
+        size_type                             m_count = 0;
+        size_type                             m_batch;
+        std::chrono::microseconds             m_maxDelay;
+        std::chrono::steady_clock::time_point m_oldest;
+
+        friend class List;
+    };
+
+    // A position for runs of edits. The cursor holds one reference on its
+    // element for its whole life and works from there; nothing it does
+    // builds iterators or pins neighbours. When its element is removed
+    // under it the cursor moves on to the first surviving successor before
+    // the next edit, or to the replacement if the element was replace()d.
+    // An element moved into another list leaves the cursor at the end of its
+    // own. A cursor must not outlive its list and is used by one thread at a
+    // time.
+    class Cursor
+    {
+    public:
+        Cursor(Cursor&& that) noexcept
+            : m_list(that.m_list)
+            , m_node(std::exchange(that.m_node, nullptr))
+        {
+        }
+
+        Cursor(const Cursor&) = delete;
+        Cursor&
+        operator=(const Cursor&) = delete;
+        Cursor&
+        operator=(Cursor&&) = delete;
+
+        ~Cursor()
+        {
+            DecRef(m_node);
+        }
+
+        T&
+        operator*() const
+        {
+            return m_node->data;
+        }
+
+        T*
+        operator->() const
+        {
+            return &m_node->data;
+        }
+
+        // on the sentinel, past the last element
+        bool
+        at_end() const
+        {
+            return m_node == m_list->m_last;
+        }
+
+        iterator
+        position() const
+        {
+            return iterator(m_node);
+        }
+
+        // Links the new element in front of the current one; the cursor
+        // stays where it is.
+        void
+        insert_before(const T& data)
+        {
+            LinkBefore(m_list->NewNode(data));
+        }
+
+        void
+        insert_before(T&& data)
+        {
+            LinkBefore(m_list->NewNode(std::move(data)));
+        }
+
+        // Links the new element in front of the current successor and moves
+        // the cursor onto it, so repeated calls build a run in call order.
+        // At the end there is no successor and the element is appended.
+        void
+        insert_after(const T& data)
+        {
+            LinkAfter(m_list->NewNode(data));
+        }
+
+        void
+        insert_after(T&& data)
+        {
+            LinkAfter(m_list->NewNode(std::move(data)));
+        }
+
+        // Removes the current element and moves on to its successor.
+        // Returns false if it was removed or replaced concurrently; the
+        // cursor then stands where that left it.
+        bool
+        erase_current()
+        {
+            if (at_end())
+                return false;
+
+            const bool erased = m_list->Unlink(m_node);
+            Settle();
+            return erased;
+        }
+
+        // Both directions stop at the end; retreating from the end starts at
+        // the back. Returns the number of steps taken.
+        size_type
+        advance(size_type n = 1)
+        {
+            size_type steps = 0;
+            for (; steps < n; ++steps)
+            {
+                Rehome();
+                if (at_end())
+                    break;
+                MoveTo(StepNext(m_node));
+            }
+            return steps;
+        }
+
+        size_type
+        retreat(size_type n = 1)
+        {
+            size_type steps = 0;
+            while (steps < n)
+            {
+                Rehome();
+                MoveTo(StepPrev(m_node));
+                ++steps;
+                if (at_end())
+                    break;
+            }
+            return steps;
+        }
+
+    private:
+        Cursor(List& list, NodePtr node)
+            : m_list(&list)
+            , m_node(node)
+        {
+            IncRef(m_node);
+        }
+
+        void
+        MoveTo(NodePtr node)
+        {
+            DecRef(std::exchange(m_node, node));
+        }
+
+        // An element spliced or merged into another list does not take the
+        // cursor along: it drops back to the end of its own list, where
+        // edits still land in the list whose counters they bump.
+        void
+        Rehome()
+        {
+            if (m_node->m_owner.load(std::memory_order_relaxed) == m_list->m_last)
+                return;
+
+            IncRef(m_list->m_last);
+            MoveTo(m_list->m_last);
+        }
+
+        // Steps off a removed element. The swapped link of a replaced one
+        // owns a reference on the replacement, which our pin keeps alive.
+        void
+        Settle()
+        {
+            for (Link l = m_node->m_next.load(std::memory_order_acquire); IsMarked(l);
+                 l = m_node->m_next.load(std::memory_order_acquire))
+            {
+                if (IsSwapped(l))
+                {
+                    IncRef(l.ptr);
+                    MoveTo(l.ptr);
+                }
+                else
+                {
+                    MoveTo(StepNext(m_node));
+                }
+            }
+            Rehome();
+        }
+
+        void
+        LinkBefore(NodePtr node)
+        {
+            if (!node)
+                throw std::bad_alloc();
+
+            for (;;)
+            {
+                Settle();
+                if (m_node->Insert(node, node, m_list->m_last))
+                    break;
+            }
+            Published();
+        }
+
+        // The successor is read straight off our link rather than pinned:
+        // the guard keeps it readable, and Insert fails on it if it was
+        // removed or moved meanwhile. At the end the sentinel itself is the
+        // successor, so the element goes to the back.
+        void
+        LinkAfter(NodePtr node)
+        {
+            if (!node)
+                throw std::bad_alloc();
+
+            IncRef(node);
+            {
+                EpochDomain::Guard guard;
+                for (;;)
+                {
+                    Settle();
+                    const Link l = m_node->m_next.load(std::memory_order_acquire);
+                    if (IsMarked(l))
+                        continue;
+                    if ((at_end() ? m_node : l.ptr)->Insert(node, node, m_list->m_last))
+                        break;
+                    Yield(m_node);
+                }
+            }
+            MoveTo(node);
+            Published();
+        }
+
+        void
+        Published()
+        {
+            Bump<kSingleProducer>(m_list->m_pushed);
+            m_list->NotifyWaiters();
+        }
+
+        List*   m_list;
+        NodePtr m_node;
+
+        friend class List;
+    };
+
+    explicit List(ExecutionMode mode = ExecutionMode::LockFree, const Allocator& alloc = Allocator())
+        : m_alloc(alloc)
+        , m_last(Node::Create(m_alloc))
+        , m_combiner(mode == ExecutionMode::FlatCombining ? std::make_unique<Combiner>() : nullptr)
+    {
+        if (!m_last)
+            throw std::bad_alloc();
+        m_last->m_owner.store(m_last, std::memory_order_relaxed);
+        m_last->m_prev.store(Link{m_last, 0}, std::memory_order_release);
+        m_last->m_next.store(Link{m_last, 0}, std::memory_order_release);
+    }
+
+    // Nodes removed earlier may still hold the sentinel through their
+    // marked links, so it is released like any other node. An allocator
+    // that may compare unequal can be torn down by the caller right after,
+    // so then the barrier returns the nodes to it first; such nodes skip the
+    // retire batches for that. Other lists leave theirs to be collected
+    // later and do not wait here.
+    ~List()
+    {
+        m_reclaimer.reset();
+        clear();
+        DecRef(m_last);
+        if constexpr (!kBatchRetire)
+            EpochDomain::Instance().Barrier();
+        if (NodePool* pool = m_pool.load(std::memory_order_acquire))
+            pool->Drop();
+        EpochDomain::Instance().Retire(m_accounting, &NodeAccounting::Drop);
+    }
+
+    explicit List(const Allocator& alloc)
+        : List(ExecutionMode::LockFree, alloc)
+    {
+    }
+
+    List(const List&) = delete;
+    List&
+    operator=(const List&) = delete;
+    List(List&&)           = delete;
+    List&
+    operator=(List&&) = delete;
+
+    iterator
+    begin()
+    {
+        return Adopt(StepNext(m_last));
+    }
+
+    T&
+    front()
+    {
+        auto it = begin();
+        if (it == end())
+            throw std::out_of_range("front() called on empty list");
+        return *it;
+    }
+
+    T&
+    back()
+    {
+        auto it = rbegin();
+        if (it == end())
+            throw std::out_of_range("back() called on empty list");
+        return *it;
+    }
+
+    const iterator
+    cbegin() const
+    {
+        return Adopt(StepNext(m_last));
+    }
+
+    const iterator
+    cend() const
+    {
+        return iterator(m_last);
+    }
+
+    iterator
+    end()
+    {
+        return iterator(m_last);
+    }
+
+    iterator
+    rbegin()
+    {
+        return Adopt(StepPrev(m_last));
+    }
+
+    iterator
+    rend()
+    {
+        return iterator(m_last);
+    }
+
+    iterator
+    pop_front()
+    {
+        if (m_combiner)
+            return Combine(Operation::PopFront, nullptr);
+        return RemoveFront();
+    }
+
+    iterator
+    pop_back()
+    {
+        if (m_combiner)
+            return Combine(Operation::PopBack, nullptr);
+        return RemoveBack();
+    }
+
+    // Awaitable pop for coroutine consumers. Completes without suspending
+    // when an element is available; otherwise the coroutine parks until a
+    // push, whose thread pops on its behalf and resumes the coroutine with
+    // `executor.execute(fn)`. The list must outlive pending awaiters. In the
+    // single-consumer models the awaiting coroutine is that consumer.
+    template<typename Executor>
+    auto
+    pop_front_async(Executor& executor)
+    {
+        return PopAwaiter<Executor, false>(*this, executor, 1);
+    }
+
+    // Resumes with between 1 and `max` elements taken from the front.
+    template<typename Executor>
+    auto
+    pop_front_async(Executor& executor, size_type max)
+    {
+        return PopAwaiter<Executor, true>(*this, executor, max);
+    }
+
+    iterator
+    push_front(const T& data)
+    {
+        return PushFront(NewNode(data));
+    }
+
+    iterator
+    push_front(T&& data)
+    {
+        return PushFront(NewNode(std::move(data)));
+    }
+
+    iterator
+    push_back(const T& data)
+    {
+        return PushBack(NewNode(data));
+    }
+
+    iterator
+    push_back(T&& data)
+    {
+        return PushBack(NewNode(std::move(data)));
+    }
+
+    iterator
+    emplace_back(const T& data)
+    {
+        return push_back(data);
+    }
+
+    iterator
+    emplace_back(T&& data)
+    {
+        return push_back(std::move(data));
+    }
+
+    iterator
+    erase(iterator it)
+    {
+        if (it == end())
+            return it;
+        return Erase(it).second;
+    }
+
+    // Swaps a new node holding `data` in for the element at `it`, which
+    // keeps its place; readers see the old value or the new one, never a
+    // mix or a gap. `it` stays on the old node, which reads as removed.
+    // Returns an iterator to the new element, or end() if the old one was
+    // removed or replaced concurrently.
+    iterator
+    replace(const iterator& it, const T& data)
+    {
+        return Swap(it.handle(), NewNode(data));
+    }
+
+    iterator
+    replace(const iterator& it, T&& data)
+    {
+        return Swap(it.handle(), NewNode(std::move(data)));
+    }
+
+    // Like replace() with fn(old value) as the new value. Since values are
+    // only ever swapped, not written in place, `fn` reads a stable copy; of
+    // two updates from the same element at most one succeeds, the other gets
+    // end() back and can retry from a fresh iterator.
+    template<typename Fn>
+    iterator
+    update(const iterator& it, Fn fn)
+    {
+        NodePtr node = it.handle();
+        if (!node || node == m_last || node->Removed())
+            return end();
+        return Swap(node, NewNode(fn(std::as_const(node->data))));
+    }
+
+    // Unlinks the element and hands its node over instead of releasing it.
+    // Returns an empty handle if the element was removed concurrently.
+    node_handle
+    extract(const iterator& it)
+    {
+        NodePtr node = it.handle();
+        if (!node || node == m_last)
+            return node_handle();
+
+        IncRef(node);
+        if (!Unlink(node))
+        {
+            DecRef(node);
+            return node_handle();
+        }
+
+        return node_handle(node);
+    }
+
+    node_handle
+    pop_front_node()
+    {
+        return TakeNode(pop_front());
+    }
+
+    node_handle
+    pop_back_node()
+    {
+        return TakeNode(pop_back());
+    }
+
+    // Links an extracted node in before `pos`, or before the first surviving
+    // successor of `pos` if that disappears concurrently. The node may come
+    // from another list of the same type; nothing is allocated or copied.
+    iterator
+    insert(const iterator& pos, node_handle&& nh)
+    {
+        NodePtr node = std::exchange(nh.m_node, nullptr);
+        if (!node)
+            return end();
+
+        // the handle's reference becomes the list's
+        Charge(node);
+        return InsertBefore(pos, node, node, 1);
+    }
+
+    // Positional inserts follow the same rule as the node handle one when
+    // `pos` disappears concurrently.
+    iterator
+    insert(const iterator& pos, const T& data)
+    {
+        NodePtr node = NewNode(data);
+        return InsertBefore(pos, node, node, 1);
+    }
+
+    iterator
+    insert(const iterator& pos, T&& data)
+    {
+        NodePtr node = NewNode(std::move(data));
+        return InsertBefore(pos, node, node, 1);
+    }
+
+    // Builds the elements into a private chain and publishes it with a
+    // single CAS: concurrent readers see either none or all of them.
+    // Returns an iterator to the first inserted element, `pos` if the range
+    // is empty.
+    template<std::input_iterator InputIt>
+    iterator
+    insert(const iterator& pos, InputIt first, InputIt last)
+    {
+        NodePtr   head  = nullptr;
+        NodePtr   tail  = nullptr;
+        size_type count = 0;
+        try
+        {
+            for (; first != last; ++first, ++count)
+                Append(head, tail, NewNode(*first));
+        }
+        catch (...)
+        {
+            DestroyChain(head, tail);
+            throw;
+        }
+
+        if (!head)
+            return pos;
+        return InsertBefore(pos, head, tail, count);
+    }
+
+    // Moves the elements of `other` in front of `pos` without allocating.
+    // They leave `other` one at a time from the front but appear here all at
+    // once, in order. Elements pushed to `other` concurrently may or may not
+    // come along.
+    void
+    splice(const iterator& pos, List& other)
+    {
+        if (&other == this)
+            return;
+
+        NodePtr   head  = nullptr;
+        NodePtr   tail  = nullptr;
+        size_type count = 0;
+        for (size_type n = other.size(); n > 0; --n, ++count)
+        {
+            node_handle nh = other.pop_front_node();
+            if (!nh)
+                break;
+            Append(head, tail, std::exchange(nh.m_node, nullptr));
+        }
+
+        if (head)
+            InsertBefore(pos, head, tail, count);
+    }
+
+    // Moves one element of `other` in front of `pos`. Returns false if it
+    // was removed concurrently.
+    bool
+    splice(const iterator& pos, List& other, const iterator& it)
+    {
+        node_handle nh = other.extract(it);
+        if (!nh)
+            return false;
+
+        insert(pos, std::move(nh));
+        return true;
+    }
+
+    // Opens a buffered producer for the back of the list; see Producer.
+    // Each pending batch costs one tail insertion instead of one per element.
+    Producer
+    producer(size_type batch = 64, std::chrono::microseconds maxDelay = std::chrono::milliseconds(1))
+    {
+        return Producer(*this, batch, maxDelay);
+    }
+
+    // Opens a cursor on the element at `pos`; see Cursor. Edits through it
+    // cost no reference counting beyond the nodes they create.
+    Cursor
+    cursor(const iterator& pos)
+    {
+        NodePtr node = pos.handle();
+        return Cursor(*this, node ? node : m_last);
+    }
+
+    // Walks the list from both ends at once, `fFront` on the calling thread
+    // from the front and `fBack` on a second thread from the back, until
+    // the two meet. Each walker claims a node before visiting it and stops
+    // at the first one the other already claimed, so every element present
+    // for the whole scan is visited exactly once, by one of them, wherever
+    // concurrent removals move the meeting point. Elements inserted or
+    // removed meanwhile are visited at most once; relocating elements with
+    // move_*() or splice() during a scan may end a walker early. Only one
+    // such scan runs at a time per list: while another is in progress,
+    // `fFront` visits everything on the calling thread. Returns how many
+    // elements each side visited.
+    template<typename FrontFn, typename BackFn>
+    std::pair<size_type, size_type>
+    scan_from_both_ends(FrontFn fFront, BackFn fBack)
+    {
+        ScanClaim claim(m_scanning);
+        if (!claim.Id())
+            return {Sweep(StepNext(m_last), true, 0, fFront), 0};
+
+        size_type back = 0;
+        size_type front;
+        {
+            std::jthread worker([&]() { back = Sweep(StepPrev(m_last), false, claim.Id(), fBack); });
+            front = Sweep(StepNext(m_last), true, claim.Id(), fFront);
+        }
+        return {front, back};
+    }
+
+    // N-way form of scan_from_both_ends(): the list is cut at `splits`,
+    // for instance iterators kept from an earlier pass, and every piece is
+    // walked from both of its ends by a thread each, 2 * (splits + 1) in
+    // all. Splits may come in any order; ones that are removed or moved
+    // away only make their neighbours walk further. `fn` is called
+    // concurrently. Returns the number of elements visited.
+    template<typename Fn>
+    size_type
+    parallel_for_each(std::span<const iterator> splits, Fn fn)
+    {
+        ScanClaim claim(m_scanning);
+        if (!claim.Id())
+            return Sweep(StepNext(m_last), true, 0, fn);
+
+        // every split starts a walker forward from it and one backward from
+        // its predecessor, so forward and backward starts alternate along
+        // the list whatever the order of the splits
+        std::vector<std::pair<NodePtr, bool>> starts;
+        starts.reserve(2 * splits.size() + 2);
+        starts.emplace_back(StepNext(m_last), true);
+        for (const iterator& split : splits)
+        {
+            NodePtr node = split.handle();
+            if (!node || node == m_last)
+                continue;
+            starts.emplace_back(StepPrev(node), false);
+            IncRef(node);
+            starts.emplace_back(node, true);
+        }
+        starts.emplace_back(StepPrev(m_last), false);
+
+        std::vector<size_type> visited(starts.size(), 0);
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(starts.size() - 1);
+            for (size_type i = 1; i < starts.size(); ++i)
+                workers.emplace_back(
+                    [&, i]() { visited[i] = Sweep(starts[i].first, starts[i].second, claim.Id(), fn); });
+            visited[0] = Sweep(starts[0].first, starts[0].second, claim.Id(), fn);
+        }
+
+        size_type total = 0;
+        for (size_type n : visited)
+            total += n;
+        return total;
+    }
+
+    // Writes the elements a forward iteration sees to `path` as a raw copy
+    // of each element. The file is written next to `path` and renamed over
+    // it once complete, so a crash never leaves a torn snapshot behind.
+    // Returns the number of elements written. It is not a point-in-time
+    // copy of a list in use: every element present for the whole dump is
+    // written once, but ones pushed or removed meanwhile may or may not be,
+    // and one moved during the dump can be written twice or missed. A raw
+    // snapshot records the element type and only loads into the same one.
+    size_type
+    dump(const std::string& path) const
+        requires std::is_trivially_copyable_v<T>
+    {
+        return Dump(path,
+                    kRawSnapshot,
+                    [](const T& value, std::string& out)
+                    { out.append(reinterpret_cast<const char*>(&value), sizeof(T)); });
+    }
+
+    // `serialize(const T&, std::string& out)` appends one element's bytes
+    // to `out`; records are stored length-prefixed.
+    template<typename Serializer>
+    size_type
+    dump(const std::string& path, Serializer serialize) const
+    {
+        return Dump(path, 0, serialize);
+    }
+
+    // Maps a snapshot written by dump() and appends its elements. The nodes
+    // are built into a private chain straight from the mapping and published
+    // with a single CAS, so concurrent readers see all of them or none.
+    // Returns the number of elements loaded.
+    size_type
+    load(const std::string& path)
+        requires std::is_trivially_copyable_v<T>
+    {
+        return Load(path,
+                    kRawSnapshot,
+                    [](std::span<const std::byte> bytes)
+                    {
+                        alignas(T) unsigned char buf[sizeof(T)];
+                        std::memcpy(buf, bytes.data(), sizeof(T));
+                        return *std::launder(reinterpret_cast<T*>(buf));
+                    });
+    }
+
+    // `deserialize(std::span<const std::byte>)` returns the element stored
+    // in one record of a snapshot written with a serializer.
+    template<typename Deserializer>
+    size_type
+    load(const std::string& path, Deserializer deserialize)
+    {
+        return Load(path, 0, deserialize);
+    }
+
+    // Unlinks the element and links the same node again at the new position:
+    // nothing is allocated or copied and iterators to it stay valid. Returns
+    // false if the element was removed concurrently.
+    bool
+    move_to_front(const iterator& it)
+    {
+        return Relocate(
+            it.handle(),
+            [this]()
+            {
+                return begin();
+            });
+    }
+
+    bool
+    move_to_back(const iterator& it)
+    {
+        return Relocate(
+            it.handle(),
+            [this]()
+            {
+                return end();
+            });
+    }
+
+    // If `pos` itself disappears concurrently the element lands in front of
+    // the first surviving successor of `pos`.
+    bool
+    move_before(const iterator& pos, const iterator& it)
+    {
+        if (!it.handle() || it.handle() == m_last)
+            return false;
+        if (pos == it)
+            return !it.handle()->Removed();
+
+        return Relocate(
+            it.handle(),
+            [p = pos, node = it.handle()]() mutable
+            {
+                while (p.handle() == node || p.handle()->Removed())
+                    ++p;
+                return p;
+            });
+    }
+
+    // Detaches the whole chain from the sentinel in O(1) and then marks the
+    // detached nodes removed one by one. Iterators into the chain stay valid
+    // and see their elements as removed; size() drops at once and is exact
+    // again when the walk is done. Concurrent pushes land in the new list.
+    void
+    clear()
+    {
+        size_type counted = 0;
+        if (NodePtr first = Detach(counted))
+            ReclaimChain(first, counted);
+    }
+
+    // Like clear(), but the walk over the detached chain runs on a
+    // background thread owned by the list; the caller only pays for the
+    // detach.
+    void
+    clear_async()
+    {
+        size_type counted = 0;
+        NodePtr   first   = Detach(counted);
+        if (!first)
+            return;
+
+        std::call_once(m_reclaimerOnce, [this]() { m_reclaimer = std::make_unique<Reclaimer>(*this); });
+        {
+            std::lock_guard<std::mutex> lock(m_reclaimer->mutex);
+            m_reclaimer->pending.emplace_back(first, counted);
+        }
+        m_reclaimer->ready.notify_one();
+    }
+
+    // Preallocates storage for at least `n` nodes in mmap'ed chunks owned
+    // by the list; from then on pushes take their nodes from that reserve
+    // and erased nodes go back to it instead of the allocator. `policy`
+    // decides what a push does once the reserve is used up. Nodes created
+    // before the first call keep coming from the allocator. The reserve
+    // stays mapped while any of its nodes is alive, also past the list.
+    void
+    reserve(size_type n, ReservePolicy policy = ReservePolicy::Grow, bool hugePages = false)
+    {
+        // erased nodes only return to the reserve after their grace period;
+        // an exhausted reserve frees what is already past it
+        std::call_once(
+            m_poolOnce,
+            [this]()
+            {
+                m_pool.store(
+                    new NodePool(sizeof(Node), alignof(Node), []() { EpochDomain::Instance().CollectNow(); }));
+            });
+        m_pool.load(std::memory_order_acquire)->Reserve(n, policy, hugePages);
+    }
+
+    // Nodes the reserve can still hand out without growing; 0 without one.
+    size_type
+    reserve_available() const
+    {
+        NodePool* pool = m_pool.load(std::memory_order_acquire);
+        return pool ? pool->available() : 0;
+    }
+
+    // Where the memory of this list's nodes is. A removed node stays pinned
+    // while an iterator, node handle or producer still holds it, then waits
+    // out its grace period as retired; both count until it is freed. Nodes
+    // moved in from another list are charged to this one from then on, so
+    // the pinned count stays free of what splice() or merge() took away.
+    // Counts are exact once the list is quiet; peaks are sampled and can
+    // miss short spikes.
+    MemoryStats
+    memory_stats() const
+    {
+        const NodeAccounting::Counts counts = m_accounting->Read();
+
+        MemoryStats stats;
+        stats.linked     = size();
+        stats.peakLinked = NodeAccounting::Raise(m_peakLinked, stats.linked);
+        stats.retired    = counts.retired;
+        stats.nodes      = counts.nodes;
+        stats.pinned     = counts.nodes > stats.linked + stats.retired ? counts.nodes - stats.linked - stats.retired : 0;
+        stats.nodeBytes  = (counts.nodes + 1) * sizeof(Node);
+        stats.peakNodes  = counts.peakNodes;
+        stats.peakBytes  = (counts.peakNodes + 1) * sizeof(Node);
+        if (NodePool* pool = m_pool.load(std::memory_order_acquire))
+            stats.reserveBytes = pool->capacity() * sizeof(Node);
+        return stats;
+    }
+
+    allocator_type
+    get_allocator() const
+    {
+        return allocator_type(m_alloc);
+    }
+
+    ExecutionMode
+    execution_mode() const
+    {
+        return m_combiner ? ExecutionMode::FlatCombining : ExecutionMode::LockFree;
+    }
+
+    static constexpr Concurrency
+    concurrency()
+    {
+        return Model;
+    }
+
+    bool
+    empty() const
+    {
+        return cbegin() == cend();
+    }
+
+    size_type
+    size() const
+    {
+        // a pop can be counted before the push of the same node
+        const size_t gone   = m_popped.load(std::memory_order_acquire) + m_cleared.load(std::memory_order_acquire);
+        const size_t pushed = m_pushed.load(std::memory_order_acquire);
+        return pushed > gone ? pushed - gone : 0;
+    }
+
+    // this method isn't thread-safe
+    template<typename Compare = std::less<T>>
+    void
+    sort(Compare comp = std::less<T>())
+    {
+        const size_t s = size();
+        if (s > 1)
+        {
+            for (size_t i = 0; i < s - 1; i++)
+            {
+                auto iter1 = begin();
+                auto iter2 = iter1;
+                ++iter2;
+                bool shouldBreak = true;
+                for (size_t j = 0; j < s - i - 1; j++, ++iter1, ++iter2)
+                {
+                    NodePtr item1 = iter1.m_ptr.load(std::memory_order_acquire);
+                    NodePtr item2 = iter2.m_ptr.load(std::memory_order_acquire);
+                    if (comp(item2->data, item1->data))
+                    {
+                        std::swap(item1->data, item2->data);
+                        shouldBreak = false;
+                    }
+                }
+
+                if (shouldBreak)
+                    break;
+            }
+        }
+    }
+
+    // Relinks the nodes of the sorted `other` into this sorted list in
+    // O(n + m) without allocating or copying; equal elements keep the ones
+    // from this list first. `other` ends up empty. Like sort(), this method
+    // isn't thread-safe: neither list may be used concurrently.
+    template<typename Compare = std::less<T>>
+    void
+    merge(List& other, Compare comp = Compare())
+    {
+        if (&other == this)
+            return;
+
+        NodePtr   a     = Next(m_last);
+        NodePtr   b     = Next(other.m_last);
+        NodePtr   tail  = m_last;
+        size_type moved = 0;
+        while (a != m_last || b != other.m_last)
+        {
+            NodePtr pick;
+            if (b == other.m_last || (a != m_last && !comp(b->data, a->data)))
+            {
+                pick = std::exchange(a, Next(a));
+            }
+            else
+            {
+                pick = std::exchange(b, Next(b));
+                pick->m_owner.store(m_last, std::memory_order_relaxed);
+                Charge(pick);
+                ++moved;
+            }
+
+            Join(tail, pick);
+            tail = pick;
+        }
+        Join(tail, m_last);
+        Join(other.m_last, other.m_last);
+
+        Bump<kSingleProducer>(m_pushed, moved);
+        other.m_cleared.fetch_add(moved, std::memory_order_acq_rel);
+        NotifyWaiters();
+    }
+
+    // k-way merge of the sorted `others` into this sorted list. Splitter
+    // keys sampled from all inputs cut every list into `threads` slices of
+    // the key range; each worker merges one slice of every list and the
+    // merged slices are stitched together at the end. Ties keep this list
+    // first, then `others` in order. Not thread-safe, like sort().
+    template<typename Compare = std::less<T>>
+    void
+    merge(std::span<List* const> others, Compare comp = Compare(), unsigned threads = std::thread::hardware_concurrency())
+    {
+        static constexpr size_type kMinSlice = 4096;
+
+        // run 0 is this list; a list named again, or this list itself among
+        // `others`, gets an empty run so its nodes are collected only once
+        std::vector<std::vector<NodePtr>> runs;
+        runs.reserve(others.size() + 1);
+        runs.push_back(Collect(*this));
+        std::vector<const List*> seen{this};
+        for (List* list : others)
+        {
+            const auto at = std::lower_bound(seen.begin(), seen.end(), list, std::less<const List*>());
+            if (at != seen.end() && *at == list)
+            {
+                runs.emplace_back();
+                continue;
+            }
+            seen.insert(at, list);
+            runs.push_back(Collect(*list));
+        }
+
+        size_type total = 0;
+        for (const auto& run : runs)
+            total += run.size();
+
+        auto less = [&comp](NodePtr x, NodePtr y) { return comp(x->data, y->data); };
+
+        // evenly spaced samples of every run, their quantiles as splitters
+        const size_type      slices = std::clamp<size_type>(std::min<size_type>(threads, total / kMinSlice), 1, 64);
+        std::vector<NodePtr> samples;
+        for (const auto& run : runs)
+            for (size_type i = 0, n = std::min<size_type>(run.size(), 8 * slices); i < n; ++i)
+                samples.push_back(run[i * run.size() / n]);
+        std::sort(samples.begin(), samples.end(), less);
+
+        // cuts[r][i] is where slice i starts in run r; lower_bound sends all
+        // elements equal to a splitter to the same slice
+        std::vector<std::vector<size_type>> cuts(runs.size(), std::vector<size_type>(slices + 1));
+        for (size_type r = 0; r < runs.size(); ++r)
+        {
+            cuts[r][slices] = runs[r].size();
+            for (size_type i = 1; i < slices; ++i)
+            {
+                NodePtr splitter = samples[i * samples.size() / slices];
+                cuts[r][i]       = std::lower_bound(runs[r].begin(), runs[r].end(), splitter, less) - runs[r].begin();
+            }
+        }
+
+        std::vector<NodePtr> heads(slices, nullptr);
+        std::vector<NodePtr> tails(slices, nullptr);
+        auto                 work = [&](size_type i) { MergeSlice(runs, cuts, i, less, heads[i], tails[i]); };
+
+        std::vector<std::thread> workers;
+        workers.reserve(slices - 1);
+        for (size_type i = 1; i < slices; ++i)
+            workers.emplace_back(work, i);
+        work(0);
+        for (auto& worker : workers)
+            worker.join();
+
+        NodePtr tail = m_last;
+        for (size_type i = 0; i < slices; ++i)
+        {
+            if (!heads[i])
+                continue;
+            Join(tail, heads[i]);
+            tail = tails[i];
+        }
+        Join(tail, m_last);
+
+        for (size_type r = 1; r < runs.size(); ++r)
+        {
+            if (runs[r].empty())
+                continue;
+            List& list = *others[r - 1];
+            Join(list.m_last, list.m_last);
+            list.m_cleared.fetch_add(runs[r].size(), std::memory_order_acq_rel);
+        }
+
+        Bump<kSingleProducer>(m_pushed, total - runs[0].size());
+        NotifyWaiters();
+    }
+
+private:
+    // Snapshot layout: the header, padded to kSnapshotAlign, then either
+    // `count` raw elements of `elemSize` bytes or `count` records of a
+    // native-endian 64-bit length followed by that many bytes. `typeTag`
+    // identifies the element type of a raw snapshot.
+    struct SnapshotHeader
+    {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t flags;
+        std::uint64_t elemSize;
+        std::uint64_t count;
+        std::uint64_t typeTag;
+    };
+
+    static_assert(std::is_trivially_copyable_v<SnapshotHeader>);
+
+    static constexpr char          kSnapshotMagic[8] = {'L', 'F', 'L', 'I', 'S', 'T', '\0', '\0'};
+    static constexpr std::uint32_t kSnapshotVersion  = 2;
+    static constexpr std::uint32_t kRawSnapshot      = 1;
+    static constexpr size_t        kSnapshotAlign    = 64;
+    static constexpr size_t        kDumpBuffer       = size_t{1} << 20;
+
+    // FNV-1a of the mangled type name, with size and alignment folded in:
+    // stable for one toolchain, which is all a raw copy of T is anyway.
+    static std::uint64_t
+    SnapshotTypeTag()
+    {
+        std::uint64_t tag = 14695981039346656037ull;
+        for (const char* c = typeid(T).name(); *c; ++c)
+            tag = (tag ^ static_cast<unsigned char>(*c)) * 1099511628211ull;
+        return tag ^ (sizeof(T) << 8 | alignof(T));
+    }
+
+    // The rename is only durable once the directory entry is; `path`'s
+    // directory is synced after it.
+    static void
+    SyncDirectory(const std::string& path)
+    {
+        const size_t      slash = path.rfind('/');
+        const std::string dir   = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        FileDescriptor    file;
+        file.fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (file.fd < 0 || ::fsync(file.fd) != 0)
+            throw std::system_error(errno, std::generic_category(), "List::dump: " + dir);
+    }
+
+    struct FileDescriptor
+    {
+        ~FileDescriptor()
+        {
+            if (fd >= 0)
+                ::close(fd);
+        }
+
+        int fd = -1;
+    };
+
+    struct Mapping
+    {
+        ~Mapping()
+        {
+            if (addr != MAP_FAILED)
+                ::munmap(addr, size);
+        }
+
+        void*  addr = MAP_FAILED;
+        size_t size = 0;
+    };
+
+    static void
+    WriteAll(int fd, const char* data, size_t size, off_t offset)
+    {
+        while (size)
+        {
+            const ssize_t n = ::pwrite(fd, data, size, offset);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+                throw std::system_error(errno, std::generic_category(), "List::dump");
+            data += n;
+            size -= static_cast<size_t>(n);
+            offset += n;
+        }
+    }
+
+    template<typename Serializer>
+    size_type
+    Dump(const std::string& path, std::uint32_t flags, Serializer serialize) const
+    {
+        const std::string tmp = path + ".tmp";
+        FileDescriptor    file;
+        file.fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (file.fd < 0)
+            throw std::system_error(errno, std::generic_category(), "List::dump: " + tmp);
+
+        try
+        {
+            return DumpTo(file.fd, tmp, path, flags, serialize);
+        }
+        catch (...)
+        {
+            ::unlink(tmp.c_str());
+            throw;
+        }
+    }
+
+    // Streams the elements behind the header slot in large writes, then
+    // fills in the header, which needs the final count, and renames the
+    // file into place.
+    template<typename Serializer>
+    size_type
+    DumpTo(int fd, const std::string& tmp, const std::string& path, std::uint32_t flags, Serializer& serialize) const
+    {
+        std::string buffer;
+        buffer.reserve(kDumpBuffer + 4096);
+        std::string record;
+        off_t       offset = kSnapshotAlign;
+        size_type   count  = 0;
+        for (auto it = cbegin(); it != cend(); ++it, ++count)
+        {
+            if (flags & kRawSnapshot)
+            {
+                serialize(*it, buffer);
+            }
+            else
+            {
+                record.clear();
+                serialize(*it, record);
+                const std::uint64_t length = record.size();
+                buffer.append(reinterpret_cast<const char*>(&length), sizeof(length));
+                buffer.append(record);
+            }
+
+            if (buffer.size() >= kDumpBuffer)
+            {
+                WriteAll(fd, buffer.data(), buffer.size(), offset);
+                offset += static_cast<off_t>(buffer.size());
+                buffer.clear();
+            }
+        }
+        WriteAll(fd, buffer.data(), buffer.size(), offset);
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+        header.version  = kSnapshotVersion;
+        header.flags    = flags;
+        header.elemSize = sizeof(T);
+        header.count    = count;
+        header.typeTag  = flags & kRawSnapshot ? SnapshotTypeTag() : 0;
+        char padded[kSnapshotAlign] = {};
+        std::memcpy(padded, &header, sizeof(header));
+        WriteAll(fd, padded, sizeof(padded), 0);
+
+        if (::fdatasync(fd) != 0 || ::rename(tmp.c_str(), path.c_str()) != 0)
+            throw std::system_error(errno, std::generic_category(), "List::dump: " + path);
+        SyncDirectory(path);
+        return count;
+    }
+
+    template<typename Deserializer>
+    size_type
+    Load(const std::string& path, std::uint32_t flags, Deserializer deserialize)
+    {
+        FileDescriptor file;
+        file.fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st;
+        if (file.fd < 0 || ::fstat(file.fd, &st) != 0)
+            throw std::system_error(errno, std::generic_category(), "List::load: " + path);
+
+        const size_t size = static_cast<size_t>(st.st_size);
+        if (size < kSnapshotAlign)
+            throw std::runtime_error("List::load: truncated snapshot " + path);
+
+        Mapping mapping;
+        mapping.addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, file.fd, 0);
+        mapping.size = size;
+        if (mapping.addr == MAP_FAILED)
+            throw std::system_error(errno, std::generic_category(), "List::load: " + path);
+        ::madvise(mapping.addr, size, MADV_SEQUENTIAL);
+
+        const void* map = mapping.addr;
+        SnapshotHeader header;
+        std::memcpy(&header, map, sizeof(header));
+        if (std::memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) != 0 ||
+            header.version != kSnapshotVersion || header.flags != flags ||
+            ((flags & kRawSnapshot) && (header.elemSize != sizeof(T) || header.typeTag != SnapshotTypeTag())))
+            throw std::runtime_error("List::load: not a compatible snapshot " + path);
+
+        const auto* data  = static_cast<const std::byte*>(map) + kSnapshotAlign;
+        const auto* limit = static_cast<const std::byte*>(map) + size;
+        if ((flags & kRawSnapshot) && header.count > static_cast<std::uint64_t>(limit - data) / sizeof(T))
+            throw std::runtime_error("List::load: truncated snapshot " + path);
+
+        NodePtr head = nullptr;
+        NodePtr tail = nullptr;
+        try
+        {
+            for (std::uint64_t i = 0; i < header.count; ++i)
+            {
+                size_t length = sizeof(T);
+                if (!(flags & kRawSnapshot))
+                {
+                    std::uint64_t stored;
+                    if (limit - data < static_cast<std::ptrdiff_t>(sizeof(stored)))
+                        throw std::runtime_error("List::load: truncated snapshot " + path);
+                    std::memcpy(&stored, data, sizeof(stored));
+                    data += sizeof(stored);
+                    if (stored > static_cast<std::uint64_t>(limit - data))
+                        throw std::runtime_error("List::load: truncated snapshot " + path);
+                    length = static_cast<size_t>(stored);
+                }
+
+                Append(head, tail, NewNode(deserialize(std::span<const std::byte>(data, length))));
+                data += length;
+            }
+        }
+        catch (...)
+        {
+            DestroyChain(head, tail);
+            throw;
+        }
+
+        if (head)
+            InsertBefore(end(), head, tail, header.count);
+        return header.count;
+    }
+
+    // Frees a private chain that was never published.
+    static void
+    DestroyChain(NodePtr head, NodePtr tail)
+    {
+        for (NodePtr node = head; node;)
+        {
+            NodeAccounting* accounting = node->m_accounting;
+            Node::Destroy(std::exchange(node, node == tail ? nullptr : node->m_next.load().ptr));
+            if (accounting)
+                accounting->CountFreed(false);
+        }
+    }
+
+    // Quiescent helpers for merge(): plain link rewrites without the
+    // locking protocol.
+    static NodePtr
+    Next(NodePtr node)
+    {
+        return node->m_next.load(std::memory_order_acquire).ptr;
+    }
+
+    static void
+    Join(NodePtr left, NodePtr right)
+    {
+        left->m_next.store(Link{right, NextTag(left->m_next.load(std::memory_order_relaxed))}, std::memory_order_release);
+        right->m_prev.store(Link{left, NextTag(right->m_prev.load(std::memory_order_relaxed))}, std::memory_order_release);
+    }
+
+    static std::vector<NodePtr>
+    Collect(List& list)
+    {
+        std::vector<NodePtr> nodes;
+        nodes.reserve(list.size());
+        for (NodePtr node = Next(list.m_last); node != list.m_last; node = Next(node))
+            nodes.push_back(node);
+        return nodes;
+    }
+
+    // Merges slice `slice` of every run into one chain; ties go to the
+    // lower run index.
+    template<typename Less>
+    void
+    MergeSlice(const std::vector<std::vector<NodePtr>>& runs,
+               const std::vector<std::vector<size_type>>& cuts,
+               size_type                                  slice,
+               Less                                       less,
+               NodePtr&                                   head,
+               NodePtr&                                   tail)
+    {
+        // min-heap of (next index, run) ordered by element, then run
+        std::vector<std::pair<size_type, size_type>> heap;
+        auto after = [&](const std::pair<size_type, size_type>& x, const std::pair<size_type, size_type>& y)
+        {
+            NodePtr a = runs[x.second][x.first];
+            NodePtr b = runs[y.second][y.first];
+            return less(b, a) || (!less(a, b) && x.second > y.second);
+        };
+        for (size_type r = 0; r < runs.size(); ++r)
+            if (cuts[r][slice] < cuts[r][slice + 1])
+                heap.emplace_back(cuts[r][slice], r);
+        std::make_heap(heap.begin(), heap.end(), after);
+
+        while (!heap.empty())
+        {
+            std::pop_heap(heap.begin(), heap.end(), after);
+            auto&   top  = heap.back();
+            NodePtr node = runs[top.second][top.first];
+            node->m_owner.store(m_last, std::memory_order_relaxed);
+            Charge(node);
+            if (tail)
+                Join(tail, node);
+            else
+                head = node;
+            tail = node;
+
+            if (++top.first < cuts[top.second][slice + 1])
+                std::push_heap(heap.begin(), heap.end(), after);
+            else
+                heap.pop_back();
+        }
+    }
+
+    template<typename... Args>
+    NodePtr
+    NewNode(Args&&... args)
+    {
+        NodePool* const pool = m_pool.load(std::memory_order_acquire);
+        NodePtr         node = pool ? Node::Create(*pool, m_alloc, std::forward<Args>(args)...)
+                                    : Node::Create(m_alloc, std::forward<Args>(args)...);
+        if (!node)
+            return node;
+
+        node->m_accounting = m_accounting;
+        // the linked peak is sampled whenever a shard publishes its batch
+        if (m_accounting->CountAllocated())
+            NodeAccounting::Raise(m_peakLinked, size());
+        return node;
+    }
+
+    // Moves the charge for a node coming in from another list over to this
+    // one, so a list's linked nodes are always among its counted ones. The
+    // caller holds a reference, so the node cannot be retired meanwhile;
+    // whoever drops the last one later reads the new accounting through the
+    // count's ordering.
+    void
+    Charge(NodePtr node)
+    {
+        NodeAccounting* const from = node->m_accounting;
+        if (from == m_accounting)
+            return;
+
+        node->m_accounting = m_accounting;
+        if (m_accounting->CountAllocated())
+            NodeAccounting::Raise(m_peakLinked, size());
+        if (from)
+            from->CountFreed(false);
+    }
+
+    // Wraps an already pinned node without taking another reference.
+    static iterator
+    Adopt(NodePtr node)
+    {
+        iterator it;
+        it.m_ptr.store(node, std::memory_order_relaxed);
+        return it;
+    }
+
+    // The list's slot for one parallel scan at a time. Id() is the scan's
+    // claim stamp, or 0 when another scan holds the slot. Ids are shared by
+    // all lists of a type, as nodes move between them with their stamps.
+    class ScanClaim
+    {
+    public:
+        explicit ScanClaim(std::atomic<bool>& busy)
+            : m_busy(busy)
+            , m_id(busy.exchange(true, std::memory_order_acquire) ? 0 : NextId())
+        {
+        }
+
+        ~ScanClaim()
+        {
+            if (m_id)
+                m_busy.store(false, std::memory_order_release);
+        }
+
+        ScanClaim(const ScanClaim&) = delete;
+        ScanClaim&
+        operator=(const ScanClaim&) = delete;
+
+        std::uint32_t
+        Id() const
+        {
+            return m_id;
+        }
+
+    private:
+        static std::uint32_t
+        NextId()
+        {
+            static std::atomic<std::uint32_t> ids{0};
+            std::uint32_t                     id;
+            do
+                id = ids.fetch_add(1, std::memory_order_relaxed) + 1;
+            while (id == 0);
+            return id;
+        }
+
+        std::atomic<bool>&  m_busy;
+        const std::uint32_t m_id;
+    };
+
+    // Visits from the pinned `node` on in one direction, claiming every
+    // node for scan `id` first. Stops at a sentinel, at a node of another
+    // list, or at a node already claimed for `id`: there it met the walker
+    // coming the other way. Id 0 claims nothing and walks to the end.
+    template<typename Fn>
+    size_type
+    Sweep(NodePtr node, bool forward, std::uint32_t id, Fn& fn)
+    {
+        size_type visited = 0;
+        while (node != m_last && node->m_owner.load(std::memory_order_relaxed) == m_last &&
+               (!id || node->m_scan.exchange(id, std::memory_order_acq_rel) != id))
+        {
+            if (!node->Removed())
+            {
+                fn(node->data);
+                ++visited;
+            }
+
+            NodePtr next = forward ? StepNext(node) : StepPrev(node);
+            DecRef(node);
+            node = next;
+        }
+        DecRef(node);
+        return visited;
+    }
+
+    // Links `fresh` in place of `node`, or drops it again if `node` is gone.
+    // A failed swap may have shown `fresh` to a reader walking backwards, so
+    // it is retired rather than freed.
+    iterator
+    Swap(NodePtr node, NodePtr fresh)
+    {
+        if (!fresh)
+            throw std::bad_alloc();
+
+        if (node && node != m_last)
+        {
+            IncRef(fresh);
+            if (node->Replace(m_last, fresh))
+                return Adopt(fresh);
+            DecRef(fresh);
+        }
+
+        DecRef(fresh);
+        return end();
+    }
+
+    bool
+    Unlink(NodePtr node)
+    {
+        if (!node->Remove(m_last).first)
+            return false;
+        Bump<kSingleConsumer>(m_popped);
+        return true;
+    }
+
+    template<typename PosFn>
+    bool
+    Relocate(NodePtr node, PosFn pos)
+    {
+        // the node keeps the list's reference and its locked m_next from
+        // the unlink until Insert links it again
+        if (!node || node == m_last || !node->Remove(m_last, true).first)
+            return false;
+
+        Relink(node, node, pos);
+        return true;
+    }
+
+    // Links the private chain first..last in before pos(); the caller has
+    // handed the list its references. A removed `last` reads as locked until
+    // Insert relinks it, so a concurrent erase waits for the move rather than
+    // reporting the element gone. Its marked link keeps the reference on the
+    // old successor until it is overwritten.
+    template<typename PosFn>
+    void
+    Relink(NodePtr first, NodePtr last, PosFn pos)
+    {
+        EpochDomain::Guard guard;
+        const Link         l = last->m_next.load(std::memory_order_acquire);
+        if (IsMarked(l))
+            last->m_next.store(Link{l.ptr, NextTag(l) | kLockBit | kMarkBit}, std::memory_order_release);
+        for (;;)
+        {
+            iterator p = pos();
+            if (p.handle()->Insert(first, last))
+                break;
+        }
+
+        if (IsMarked(l))
+            DecRef(l.ptr);
+        NotifyWaiters();
+    }
+
+    // Pins `first` for the result and links the chain in front of `pos`, or
+    // of the first surviving successor of `pos`.
+    iterator
+    InsertBefore(const iterator& pos, NodePtr first, NodePtr last, size_type count)
+    {
+        IncRef(first);
+        Relink(
+            first,
+            last,
+            [p = pos]() mutable
+            {
+                while (p.handle()->Removed())
+                    ++p;
+                return p;
+            });
+        Bump<kSingleProducer>(m_pushed, count);
+        return Adopt(first);
+    }
+
+    // Appends a fresh or removed node to a private chain. The owner is set
+    // before the node becomes reachable from the chain; a removed tail drops
+    // its marked link's reference once the link is overwritten.
+    void
+    Append(NodePtr& head, NodePtr& tail, NodePtr node)
+    {
+        node->m_owner.store(m_last, std::memory_order_relaxed);
+        Charge(node);
+        if (!head)
+        {
+            head = tail = node;
+            return;
+        }
+
+        const Link l = tail->m_next.load(std::memory_order_acquire);
+        node->m_prev.store(Link{tail, NextTag(node->m_prev.load(std::memory_order_relaxed))}, std::memory_order_release);
+        tail->m_next.store(Link{node, NextTag(l)}, std::memory_order_release);
+        if (IsMarked(l))
+            DecRef(l.ptr);
+        tail = node;
+    }
+
+    // Moves the pin of a popped element into a handle.
+    node_handle
+    TakeNode(iterator it)
+    {
+        NodePtr node = it.m_ptr.exchange(nullptr, std::memory_order_acq_rel);
+        if (node == m_last)
+        {
+            DecRef(node);
+            return node_handle();
+        }
+
+        return node_handle(node);
+    }
+
+    // Marks a detached node removed unless someone else is already removing
+    // it. The marked link takes its own reference on the successor.
+    static bool
+    MarkDetached(NodePtr node)
+    {
+        Link l = node->m_next.load(std::memory_order_acquire);
+        if (l.tag & kFlagMask || !TryIncRef(l.ptr))
+            return false;
+
+        if (node->m_next.compare_exchange_strong(
+                l, Link{l.ptr, NextTag(l) | kMarkBit}, std::memory_order_acq_rel, std::memory_order_acquire))
+            return true;
+
+        DecRef(l.ptr);
+        return false;
+    }
+
+    // Cuts the chain off the sentinel by locking both sentinel links and
+    // marking the first node; everything behind it then fails IsLinked until
+    // the walk reaches it. Returns the first node, pinned by the list's
+    // reference, and charges the current size to m_cleared.
+    NodePtr
+    Detach(size_type& counted)
+    {
+        EpochDomain::Guard guard;
+        Link               tailL = m_last->m_prev.load(std::memory_order_acquire);
+        for (;;)
+        {
+            if (IsLocked(tailL))
+            {
+                std::this_thread::yield();
+                tailL = m_last->m_prev.load(std::memory_order_acquire);
+                continue;
+            }
+
+            if (m_last->m_prev.compare_exchange_weak(
+                    tailL,
+                    Link{tailL.ptr, NextTag(tailL) | kLockBit},
+                    std::memory_order_acq_rel,
+                    std::memory_order_acquire))
+                break;
+        }
+        const Link lockTail{tailL.ptr, NextTag(tailL) | kLockBit};
+
+        for (;;)
+        {
+            Link headL = m_last->m_next.load(std::memory_order_acquire);
+            if (IsLocked(headL))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            const Link lockHead{headL.ptr, NextTag(headL) | kLockBit};
+            if (!m_last->m_next.compare_exchange_weak(
+                    headL, lockHead, std::memory_order_acq_rel, std::memory_order_acquire))
+                continue;
+
+            NodePtr first = headL.ptr;
+            if (first == m_last || !MarkDetached(first))
+            {
+                // a remover of the first node waits on our lock to finish
+                m_last->m_next.exchange(Link{first, NextTag(lockHead)}, std::memory_order_acq_rel);
+                if (first != m_last)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                m_last->m_prev.store(Link{tailL.ptr, NextTag(lockTail)}, std::memory_order_release);
+                return nullptr;
+            }
+
+            counted = size();
+            m_cleared.fetch_add(counted, std::memory_order_acq_rel);
+            m_last->m_prev.store(Link{m_last, NextTag(lockTail)}, std::memory_order_release);
+            m_last->m_next.exchange(Link{m_last, NextTag(lockHead)}, std::memory_order_acq_rel);
+            return first;
+        }
+    }
+
+    // Walks a detached chain marking each node removed and dropping the
+    // list's reference; a node is freed once its predecessor is. Nodes a
+    // concurrent erase or insert is working on are waited out: both finish
+    // by swinging the link the walk reads next. `counted` is what Detach
+    // charged to m_cleared, corrected here to the number actually marked.
+    // The node read from the link needs no reference of its own: the guard
+    // keeps its memory, and marking only succeeds while the list still holds
+    // it, which then passes to the walk.
+    void
+    ReclaimChain(NodePtr anchor, size_type counted)
+    {
+        size_type marked = 1;
+        for (;;)
+        {
+            EpochDomain::Guard guard;
+            NodePtr            node = anchor->m_next.load(std::memory_order_acquire).ptr;
+            if (node == m_last)
+                break;
+
+            if (!MarkDetached(node))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            ++marked;
+            DecRef(std::exchange(anchor, node));
+        }
+
+        DecRef(anchor);
+        m_cleared.fetch_add(marked - counted, std::memory_order_acq_rel);
+    }
+
+    std::pair<bool, iterator>
+    Erase(iterator it)
+    {
+        NodePtr h = it.handle();
+        if (!h)
+            return std::make_pair(false, end());
+        std::pair<bool, NodePtr> res = h->Remove(m_last);
+        if (res.first)
+            Bump<kSingleConsumer>(m_popped);
+
+        return std::make_pair(res.first, Adopt(StepNext(h)));
+    }
+
+    enum class Operation : int
+    {
+        None,
+        Claimed,
+        PushFront,
+        PushBack,
+        PopFront,
+        PopBack,
+        Done
+    };
+
+    struct Combiner
+    {
+        struct alignas(64) Slot
+        {
+            std::atomic<Operation> state{Operation::None};
+            NodePtr                node = nullptr;
+            iterator               result;
+        };
+
+        static constexpr size_t kSlots = 64;
+
+        Slot                          slots[kSlots];
+        alignas(64) std::atomic<bool> busy{false};
+    };
+
+    iterator
+    PushFront(NodePtr newNode)
+    {
+        if (!newNode)
+            throw std::bad_alloc();
+        iterator it = m_combiner ? Combine(Operation::PushFront, newNode) : InsertFront(newNode);
+        NotifyWaiters();
+        return it;
+    }
+
+    iterator
+    InsertFront(NodePtr newNode)
+    {
+        IncRef(newNode);
+        for (;;)
+        {
+            NodePtr    first    = StepNext(m_last);
+            const bool inserted = first->Insert(newNode);
+            DecRef(first);
+            if (inserted)
+                break;
+        }
+
+        Bump<kSingleProducer>(m_pushed);
+        return Adopt(newNode);
+    }
+
+    iterator
+    PushBack(NodePtr newNode)
+    {
+        if (!newNode)
+            throw std::bad_alloc();
+        iterator it = m_combiner ? Combine(Operation::PushBack, newNode) : InsertBack(newNode);
+        NotifyWaiters();
+        return it;
+    }
+
+    // the sentinel is never removed, so inserting before it cannot fail
+    iterator
+    InsertBack(NodePtr newNode)
+    {
+        IncRef(newNode);
+        m_last->Insert(newNode);
+        Bump<kSingleProducer>(m_pushed);
+        return Adopt(newNode);
+    }
+
+    // The pin taken while stepping becomes the returned iterator; unlike
+    // Erase there is no successor iterator to build.
+    iterator
+    RemoveFront()
+    {
+        if constexpr (kSingleConsumer)
+            return RemoveEnd(m_last->m_next.load(std::memory_order_acquire).ptr);
+
+        for (;;)
+        {
+            NodePtr node = StepNext(m_last);
+            if (node == m_last)
+                return Adopt(node);
+            if (Unlink(node))
+                return Adopt(node);
+            DecRef(node);
+        }
+    }
+
+    iterator
+    RemoveBack()
+    {
+        if constexpr (kSingleConsumer)
+            return RemoveEnd(m_last->m_prev.load(std::memory_order_acquire).ptr);
+
+        for (;;)
+        {
+            NodePtr node = StepPrev(m_last);
+            if (node == m_last)
+                return Adopt(node);
+            if (Unlink(node))
+                return Adopt(node);
+            DecRef(node);
+        }
+    }
+
+    // Pop for the single-consumer models. Nobody else removes or moves
+    // nodes, so the end node read off the sentinel is linked and holds the
+    // list's reference until we unlink it: a plain IncRef pins it without a
+    // guard or a retry, and the unlink cannot lose. A producer locks the
+    // sentinel links without changing their pointers, so this never reads a
+    // half-inserted node.
+    iterator
+    RemoveEnd(NodePtr node)
+    {
+        IncRef(node);
+        if (node != m_last)
+            Unlink(node);
+        return Adopt(node);
+    }
+
+    typename Combiner::Slot&
+    AcquireSlot()
+    {
+        static thread_local const size_t hint = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        for (size_t i = hint;; ++i)
+        {
+            auto&     slot     = m_combiner->slots[i % Combiner::kSlots];
+            Operation expected = Operation::None;
+            if (slot.state.compare_exchange_strong(
+                    expected, Operation::Claimed, std::memory_order_acquire, std::memory_order_relaxed))
+                return slot;
+
+            if ((i - hint) % Combiner::kSlots == Combiner::kSlots - 1)
+                std::this_thread::yield();
+        }
+    }
+
+    // The requests of one pass are concurrent, so any order among them is a
+    // valid one. The pushes for each end are chained privately and linked
+    // with a single Insert, one CAS on the neighbour's m_next rather than
+    // one per request; the pops come after and may take what was just
+    // pushed. Slots published during the pass wait for the next one.
+    void
+    ApplyRequests()
+    {
+        typename Combiner::Slot* pushes[Combiner::kSlots];
+        size_type                count     = 0;
+        NodePtr                  frontHead = nullptr;
+        NodePtr                  frontTail = nullptr;
+        NodePtr                  backHead  = nullptr;
+        NodePtr                  backTail  = nullptr;
+        for (auto& slot : m_combiner->slots)
+        {
+            const Operation op = slot.state.load(std::memory_order_acquire);
+            if (op != Operation::PushFront && op != Operation::PushBack)
+                continue;
+
+            // the result's reference
+            IncRef(slot.node);
+            if (op == Operation::PushFront)
+                Append(frontHead, frontTail, slot.node);
+            else
+                Append(backHead, backTail, slot.node);
+            pushes[count++] = &slot;
+        }
+
+        if (backHead)
+            m_last->Insert(backHead, backTail);
+        while (frontHead)
+        {
+            NodePtr    first    = StepNext(m_last);
+            const bool inserted = first->Insert(frontHead, frontTail);
+            DecRef(first);
+            if (inserted)
+                break;
+        }
+        Bump<kSingleProducer>(m_pushed, count);
+
+        for (size_type i = 0; i < count; ++i)
+        {
+            pushes[i]->result = Adopt(pushes[i]->node);
+            pushes[i]->state.store(Operation::Done, std::memory_order_release);
+        }
+
+        for (auto& slot : m_combiner->slots)
+        {
+            switch (slot.state.load(std::memory_order_acquire))
+            {
+            case Operation::PopFront:
+                slot.result = RemoveFront();
+                break;
+            case Operation::PopBack:
+                slot.result = RemoveBack();
+                break;
+            default:
+                continue;
+            }
+
+            slot.state.store(Operation::Done, std::memory_order_release);
+        }
+    }
+
+    // Publishes the request in a slot and either waits for the current
+    // combiner to apply it or becomes the combiner itself.
+    iterator
+    Combine(Operation op, NodePtr node)
+    {
+        auto& slot = AcquireSlot();
+        slot.node  = node;
+        slot.state.store(op, std::memory_order_release);
+
+        for (;;)
+        {
+            if (!m_combiner->busy.load(std::memory_order_relaxed) &&
+                !m_combiner->busy.exchange(true, std::memory_order_acquire))
+            {
+                ApplyRequests();
+                m_combiner->busy.store(false, std::memory_order_release);
+            }
+
+            if (slot.state.load(std::memory_order_acquire) == Operation::Done)
+                break;
+
+            std::this_thread::yield();
+        }
+
+        iterator res = std::move(slot.result);
+        slot.node    = nullptr;
+        slot.state.store(Operation::None, std::memory_order_release);
+        return res;
+    }
+
+    // Background thread behind clear_async(). It only exits once every
+    // chain handed to it has been walked.
+    struct Reclaimer
+    {
+        explicit Reclaimer(List& list)
+            : thread(
+                  [this, &list](std::stop_token stop)
+                  {
+                      std::unique_lock<std::mutex> lock(mutex);
+                      for (;;)
+                      {
+                          ready.wait(lock, stop, [this]() { return !pending.empty(); });
+                          if (pending.empty())
+                              return;
+
+                          auto chains = std::exchange(pending, {});
+                          lock.unlock();
+                          for (auto [first, counted] : chains)
+                              list.ReclaimChain(first, counted);
+                          lock.lock();
+                      }
+                  })
+        {
+        }
+
+        std::mutex                                  mutex;
+        std::condition_variable_any                 ready;
+        std::vector<std::pair<NodePtr, size_type>> pending;
+        std::jthread                                thread;
+    };
+
+    // A coroutine parked in pop_front_async. Whoever serves it fills in the
+    // popped elements before handing it to the executor.
+    struct AsyncWaiter
+    {
+        AsyncWaiter*            next = nullptr;
+        size_type               max  = 1;
+        iterator                first;
+        std::vector<iterator>   more;
+        std::coroutine_handle<> handle;
+        void*                   executor = nullptr;
+        void (*schedule)(AsyncWaiter*)   = nullptr;
+    };
+
+    template<typename Executor, bool Batch>
+    class PopAwaiter
+    {
+    public:
+        PopAwaiter(List& list, Executor& executor, size_type max)
+            : m_list(list)
+        {
+            m_waiter.max      = max ? max : 1;
+            m_waiter.executor = &executor;
+            m_waiter.schedule = &Schedule;
+        }
+
+        bool
+        await_ready()
+        {
+            m_list.TakeFront(m_waiter);
+            return m_waiter.first.handle() != nullptr;
+        }
+
+        void
+        await_suspend(std::coroutine_handle<> h)
+        {
+            m_waiter.handle = h;
+            m_list.Park(&m_waiter);
+        }
+
+        auto
+        await_resume()
+        {
+            if constexpr (Batch)
+            {
+                std::vector<iterator> out;
+                out.reserve(1 + m_waiter.more.size());
+                out.push_back(std::move(m_waiter.first));
+                for (auto& it : m_waiter.more)
+                    out.push_back(std::move(it));
+                return out;
+            }
+            else
+                return std::move(m_waiter.first);
+        }
+
+    private:
+        static void
+        Schedule(AsyncWaiter* w)
+        {
+            static_cast<Executor*>(w->executor)->execute(
+                [h = w->handle]()
+                {
+                    h.resume();
+                });
+        }
+
+        List&       m_list;
+        AsyncWaiter m_waiter;
+    };
+
+    void
+    TakeFront(AsyncWaiter& w)
+    {
+        if (!w.first.handle())
+        {
+            w.first = pop_front();
+            if (w.first == end())
+            {
+                w.first = iterator();
+                return;
+            }
+        }
+
+        while (w.more.size() + 1 < w.max)
+        {
+            iterator it = pop_front();
+            if (it == end())
+                break;
+            w.more.push_back(std::move(it));
+        }
+    }
+
+    // Producers only pay this relaxed load while nobody is parked. Its
+    // visibility comes from Park: see there.
+    void
+    NotifyWaiters()
+    {
+        if (m_waiterCount.load(std::memory_order_relaxed) != 0)
+            ServeWaiters();
+    }
+
+    void
+    Park(AsyncWaiter* w)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+            *m_waitTail = w;
+            m_waitTail  = &w->next;
+            m_waiterCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Every insert into an empty list ends with a CAS on the sentinel's
+        // m_next. Touching that link with a no-op CAS puts us in its
+        // modification order: a producer whose CAS comes later synchronizes
+        // with this one and must see the count, and anything linked earlier
+        // is visible to the ServeWaiters below.
+        Link l = m_last->m_next.load(std::memory_order_relaxed);
+        while (!m_last->m_next.compare_exchange_weak(l, l, std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+        }
+
+        ServeWaiters();
+    }
+
+    // Pops for parked coroutines in arrival order and schedules those that
+    // got an element. Executors run outside the lock, so a resumed
+    // coroutine may park again right away.
+    void
+    ServeWaiters()
+    {
+        AsyncWaiter*  ready = nullptr;
+        AsyncWaiter** tail  = &ready;
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+            while (AsyncWaiter* w = m_waitHead)
+            {
+                TakeFront(*w);
+                if (!w->first.handle())
+                    break;
+
+                m_waitHead = w->next;
+                if (!m_waitHead)
+                    m_waitTail = &m_waitHead;
+                m_waiterCount.fetch_sub(1, std::memory_order_relaxed);
+
+                w->next = nullptr;
+                *tail   = w;
+                tail    = &w->next;
+            }
+        }
+
+        while (AsyncWaiter* w = ready)
+        {
+            ready = w->next;
+            w->schedule(w);
+        }
+    }
+
+    [[no_unique_address]] NodeAllocator m_alloc;
+
+    NodePtr                   m_last;
+    std::unique_ptr<Combiner> m_combiner;
+
+    alignas(64) std::atomic<size_t> m_pushed{0};
+    alignas(64) std::atomic<size_t> m_popped{0};
+    alignas(64) std::atomic<size_t> m_cleared{0};
+
+    alignas(64) std::atomic<size_t> m_waiterCount{0};
+    std::mutex                      m_waitMutex;
+    AsyncWaiter*                    m_waitHead = nullptr;
+    AsyncWaiter**                   m_waitTail = &m_waitHead;
+
+    std::once_flag             m_reclaimerOnce;
+    std::unique_ptr<Reclaimer> m_reclaimer;
+
+    std::once_flag          m_poolOnce;
+    std::atomic<NodePool*> m_pool{nullptr};
+
+    NodeAccounting* const            m_accounting = new NodeAccounting;
+    mutable std::atomic<std::size_t> m_peakLinked{0};
+
+    std::atomic<bool> m_scanning{false};
+};
+
+namespace pmr
+{
+template<typename T, Concurrency Model = Concurrency::MPMC>
+using List = ::List<T, std::pmr::polymorphic_allocator<T>, Model>;
+}
\ No newline at end of file
@@ -1,11 +1,28 @@
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
 #include <cstdlib>
 #include <cassert>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
 #include <iostream>
+#include <iterator>
+#include <numeric>
 #include <random>
 #include <string>
+#include <memory_resource>
+#include <sstream>
 #include <stdexcept>
 
+#include "arena_list.hpp"
+#include "concurrent_lru_cache.hpp"
+#include "expiring_list.hpp"
 #include "lockfree_list.hpp"
+#include "numa_list.hpp"
+#include "work_stealing_list.hpp"
 
 #include <set>
 
@@ -579,6 +596,2062 @@ test_self_assignment()
     std::cout << "PASSED: test_self_assignment" << std::endl;
 }
 
+static void
+test_flat_combining()
+{
+    std::cout << "Running test_flat_combining..." << std::endl;
+    List<int> l(ExecutionMode::FlatCombining);
+    TEST_ASSERT(l.execution_mode() == ExecutionMode::FlatCombining);
+
+    l.push_back(2);
+    l.push_front(1);
+    l.push_back(3);
+    TEST_ASSERT(l.size() == 3);
+    TEST_ASSERT(l.front() == 1 && l.back() == 3);
+    TEST_ASSERT(*l.pop_back() == 3);
+    TEST_ASSERT(*l.pop_front() == 1);
+    TEST_ASSERT(l.pop_front() != l.end());
+    TEST_ASSERT(l.pop_front() == l.end());
+
+    unsigned int hw = std::thread::hardware_concurrency();
+    if (hw == 0)
+        hw = 4;
+
+    const int        threads    = static_cast<int>(hw) * 2;
+    constexpr int    per_thread = 200;
+    std::atomic<int> popped_sum{0};
+
+    auto worker = [&l, &popped_sum](int start)
+    {
+        for (int i = 0; i < per_thread; ++i)
+        {
+            if (i % 2 == 0)
+                l.push_back(start + i);
+            else
+                l.push_front(start + i);
+
+            auto it = (i % 3 == 0) ? l.pop_back() : l.pop_front();
+            if (it != l.end())
+                popped_sum.fetch_add(*it, std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<std::thread> th;
+    for (int t = 0; t < threads; ++t)
+        th.emplace_back(worker, t * per_thread);
+
+    for (auto& x : th)
+        x.join();
+
+    int remaining_sum = 0;
+    for (auto it = l.begin(); it != l.end(); ++it)
+        remaining_sum += *it;
+
+    const int total = threads * per_thread;
+    TEST_ASSERT(l.size() == 0);
+    TEST_ASSERT(popped_sum.load() + remaining_sum == total * (total - 1) / 2);
+
+    // a combining pass links the pushes of each end as one chain; every
+    // pusher still gets an iterator to its own element
+    List<int> pushed(ExecutionMode::FlatCombining);
+    th.clear();
+    for (int t = 0; t < threads; ++t)
+        th.emplace_back(
+            [&pushed, t]()
+            {
+                for (int i = 0; i < per_thread; ++i)
+                {
+                    const int v  = t * per_thread + i;
+                    auto      it = i % 2 ? pushed.push_front(v) : pushed.push_back(v);
+                    TEST_ASSERT(*it == v);
+                }
+            });
+    for (auto& x : th)
+        x.join();
+
+    std::vector<int> all;
+    for (int v : pushed)
+        all.push_back(v);
+    std::sort(all.begin(), all.end());
+    TEST_ASSERT(pushed.size() == static_cast<size_t>(total) && all.size() == static_cast<size_t>(total));
+    for (int i = 0; i < total; ++i)
+        TEST_ASSERT(all[i] == i);
+    std::cout << "PASSED: test_flat_combining" << std::endl;
+}
+
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    std::atomic<long> allocations{0};
+    std::atomic<long> outstanding{0};
+
+private:
+    void*
+    do_allocate(std::size_t bytes, std::size_t align) override
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        outstanding.fetch_add(1, std::memory_order_relaxed);
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+
+    void
+    do_deallocate(void* p, std::size_t bytes, std::size_t align) override
+    {
+        outstanding.fetch_sub(1, std::memory_order_relaxed);
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+
+    bool
+    do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+static void
+test_custom_allocator()
+{
+    std::cout << "Running test_custom_allocator..." << std::endl;
+    CountingResource res;
+    {
+        pmr::List<int> l(&res);
+        TEST_ASSERT(l.get_allocator().resource() == &res);
+        TEST_ASSERT(res.allocations.load() == 1);
+
+        for (int i = 0; i < 10; ++i)
+        {
+            l.push_front(i);
+            l.push_back(i);
+        }
+        TEST_ASSERT(res.allocations.load() == 21);
+
+        // pin a node and release it from another thread
+        auto it = l.pop_front();
+        TEST_ASSERT(*it == 9);
+        std::thread([pinned = std::move(it)]() mutable
+                    {
+                        TEST_ASSERT(*pinned == 9);
+                        pinned = {};
+                    })
+            .join();
+        // freed nodes go back to the resource once no reader can see them
+        EpochDomain::Instance().Barrier();
+        TEST_ASSERT(res.outstanding.load() == 20);
+
+        std::vector<std::thread> th;
+        for (int t = 0; t < 4; ++t)
+            th.emplace_back(
+                [&l]()
+                {
+                    for (int i = 0; i < 4; ++i)
+                        l.pop_back();
+                });
+        for (auto& x : th)
+            x.join();
+        TEST_ASSERT(l.size() == 3);
+        EpochDomain::Instance().Barrier();
+        TEST_ASSERT(res.outstanding.load() == 4);
+    }
+    TEST_ASSERT(res.outstanding.load() == 0);
+    std::cout << "PASSED: test_custom_allocator" << std::endl;
+}
+
+static void
+test_numa_list()
+{
+    std::cout << "Running test_numa_list..." << std::endl;
+    NumaList<int> l(NumaTopology::Simulated(2, 1));
+    TEST_ASSERT(l.nodes() == 2);
+
+    std::thread(
+        [&l]()
+        {
+            NumaTopology::BindThread(1);
+            for (int i = 0; i < 10; ++i)
+                l.push_back(i);
+        })
+        .join();
+
+    TEST_ASSERT(l.size() == 10);
+    TEST_ASSERT(l.sub_list(0).empty());
+    TEST_ASSERT(l.sub_list(1).size() == 10);
+
+    NumaTopology::BindThread(0);
+    l.push_back(100);
+    auto res = l.pop_front();
+    TEST_ASSERT(res.first && *res.second == 100);
+
+    res = l.pop_front();
+    TEST_ASSERT(res.first && *res.second == 0);
+    TEST_ASSERT(l.stats().steals == 1);
+
+    int sum = 0;
+    l.for_each(
+        [&sum](int v)
+        {
+            sum += v;
+        });
+    TEST_ASSERT(sum == 45);
+
+    while (l.pop_back().first)
+        ;
+    TEST_ASSERT(l.empty());
+    NumaTopology::BindThread(-1);
+    std::cout << "PASSED: test_numa_list" << std::endl;
+}
+
+static void
+test_arena_list()
+{
+    std::cout << "Running test_arena_list..." << std::endl;
+    ArenaList<int> l(8);
+    TEST_ASSERT(l.empty());
+    TEST_ASSERT(l.capacity() == 8);
+
+    for (int i = 0; i < 4; ++i)
+        l.push_back(i);
+    l.push_front(-1);
+    TEST_ASSERT(l.size() == 5);
+    TEST_ASSERT(l.front() == -1 && l.back() == 3);
+
+    auto snap = l.snapshot();
+    TEST_ASSERT((snap == std::vector<int>{-1, 0, 1, 2, 3}));
+
+    for (int i = 5; i < 8; ++i)
+        l.push_back(i);
+
+    bool caught = false;
+    try
+    {
+        l.push_back(99);
+    }
+    catch (const std::bad_alloc&)
+    {
+        caught = true;
+    }
+    TEST_ASSERT(caught);
+
+    TEST_ASSERT(*l.pop_front() == -1);
+    TEST_ASSERT(*l.pop_back() == 7);
+    l.push_back(8);
+    l.push_back(9);
+    TEST_ASSERT(l.size() == 8);
+
+    auto it = l.begin();
+    ++it;
+    it = l.erase(it);
+    TEST_ASSERT(*it == 2);
+    l.clear();
+    TEST_ASSERT(l.empty() && l.size() == 0);
+
+    ArenaList<int>   shared(1024);
+    std::atomic<int> popped_sum{0};
+    std::vector<std::thread> th;
+    for (int t = 0; t < 4; ++t)
+        th.emplace_back(
+            [&shared, &popped_sum, t]()
+            {
+                for (int i = 0; i < 500; ++i)
+                {
+                    shared.push_back(t * 500 + i);
+                    auto popped = (i % 2) ? shared.pop_front() : shared.pop_back();
+                    if (popped != shared.end())
+                        popped_sum.fetch_add(*popped, std::memory_order_relaxed);
+                }
+            });
+    for (auto& x : th)
+        x.join();
+
+    TEST_ASSERT(shared.empty());
+    TEST_ASSERT(popped_sum.load() == 2000 * 1999 / 2);
+
+    // walks in both directions race pops that free the slots they are
+    // about to step onto; a slot revived after its free would be read
+    // destroyed and pushed onto the free stack twice
+    constexpr std::size_t    kSlots = 16;
+    ArenaList<std::string>   churn(kSlots);
+    std::atomic<bool>        stop{false};
+    std::vector<std::thread> walkers;
+    const std::string        prefix(32, 'x');
+    for (int t = 0; t < 2; ++t)
+        walkers.emplace_back(
+            [&churn, &stop, &prefix, t]()
+            {
+                while (!stop.load(std::memory_order_acquire))
+                {
+                    if (t == 0)
+                    {
+                        for (auto it = churn.begin(); it != churn.end(); ++it)
+                            TEST_ASSERT(it->compare(0, prefix.size(), prefix) == 0);
+                    }
+                    else
+                    {
+                        for (auto it = churn.rbegin(); it != churn.rend(); --it)
+                            TEST_ASSERT(it->compare(0, prefix.size(), prefix) == 0);
+                    }
+                }
+            });
+    th.clear();
+    for (int t = 0; t < 2; ++t)
+        th.emplace_back(
+            [&churn, &prefix, t]()
+            {
+                for (int i = 0; i < 20000; ++i)
+                {
+                    if (churn.size() < kSlots / 2)
+                        churn.push_back(prefix + std::to_string(i));
+                    if (i % 2 == t)
+                        churn.pop_front();
+                    else
+                        churn.pop_back();
+                }
+            });
+    for (auto& x : th)
+        x.join();
+    stop.store(true, std::memory_order_release);
+    for (auto& x : walkers)
+        x.join();
+
+    // every slot is back exactly once
+    churn.clear();
+    for (std::size_t i = 0; i < kSlots; ++i)
+        churn.push_back(prefix);
+    caught = false;
+    try
+    {
+        churn.push_back(prefix);
+    }
+    catch (const std::bad_alloc&)
+    {
+        caught = true;
+    }
+    TEST_ASSERT(caught && churn.size() == kSlots && churn.snapshot().size() == kSlots);
+    std::cout << "PASSED: test_arena_list" << std::endl;
+}
+
+template<typename L>
+static std::vector<int>
+to_vector(L& l)
+{
+    std::vector<int> v;
+    for (auto it = l.begin(); it != l.end(); ++it)
+        v.push_back(*it);
+    return v;
+}
+
+static void
+test_move_to_front()
+{
+    std::cout << "Running test_move_to_front..." << std::endl;
+    List<int>                       l;
+    std::vector<List<int>::iterator> handles;
+    for (int i = 0; i < 5; ++i)
+        handles.push_back(l.push_back(i));
+
+    TEST_ASSERT(l.move_to_front(handles[3]));
+    TEST_ASSERT((to_vector(l) == std::vector<int>{3, 0, 1, 2, 4}));
+    TEST_ASSERT(*handles[3] == 3);
+
+    TEST_ASSERT(l.move_to_back(handles[0]));
+    TEST_ASSERT((to_vector(l) == std::vector<int>{3, 1, 2, 4, 0}));
+
+    TEST_ASSERT(l.move_before(handles[1], handles[4]));
+    TEST_ASSERT((to_vector(l) == std::vector<int>{3, 4, 1, 2, 0}));
+    TEST_ASSERT(l.move_before(handles[2], handles[2]));
+    TEST_ASSERT(!l.move_before(l.end(), l.end()));
+    TEST_ASSERT(!l.move_before(List<int>::iterator(), List<int>::iterator()));
+    TEST_ASSERT(l.size() == 5);
+
+    // the handle survives the move and still erases the right element
+    l.erase(handles[4]);
+    TEST_ASSERT((to_vector(l) == std::vector<int>{3, 1, 2, 0}));
+    TEST_ASSERT(!l.move_to_front(handles[4]));
+    TEST_ASSERT(l.size() == 4);
+
+    List<int>                        shared;
+    std::vector<List<int>::iterator> shared_handles;
+    for (int i = 0; i < 64; ++i)
+        shared_handles.push_back(shared.push_back(i));
+
+    std::vector<std::thread> th;
+    for (int t = 0; t < 4; ++t)
+        th.emplace_back(
+            [&shared, &shared_handles, t]()
+            {
+                std::mt19937 rng(t);
+                for (int i = 0; i < 500; ++i)
+                {
+                    auto& h = shared_handles[rng() % shared_handles.size()];
+                    if (i % 2)
+                        shared.move_to_front(h);
+                    else
+                        shared.move_to_back(h);
+                }
+            });
+    for (auto& x : th)
+        x.join();
+
+    auto v = to_vector(shared);
+    std::sort(v.begin(), v.end());
+    TEST_ASSERT(shared.size() == 64);
+    TEST_ASSERT(v.size() == 64);
+    for (int i = 0; i < 64; ++i)
+        TEST_ASSERT(v[i] == i);
+    std::cout << "PASSED: test_move_to_front" << std::endl;
+}
+
+// Erases and relocates elements near the front while pushing at the front and
+// popping at the back, so removals keep meeting removals and inserts on their
+// predecessor. Every operation has to finish, and the list has to read the
+// same forwards, backwards and in size() afterwards.
+static void
+test_hot_front_churn()
+{
+    std::cout << "Running test_hot_front_churn..." << std::endl;
+    for (int round = 0; round < 40; ++round)
+    {
+        List<int> l;
+        for (int i = 0; i < 64; ++i)
+            l.push_back(i);
+
+        std::vector<std::thread> th;
+        for (int t = 0; t < 4; ++t)
+            th.emplace_back(
+                [&l, round, t]()
+                {
+                    std::mt19937 rng(round * 4 + t);
+                    for (int i = 0; i < 200; ++i)
+                    {
+                        auto      it    = l.begin();
+                        const int steps = static_cast<int>(rng() % 48);
+                        for (int s = 0; s < steps && it != l.end(); ++s)
+                            ++it;
+
+                        if (round % 2 && rng() % 2)
+                        {
+                            if (it != l.end())
+                                l.move_to_front(it);
+                            l.pop_back();
+                        }
+                        else if (it != l.end())
+                        {
+                            l.erase(it);
+                        }
+                        l.push_front(i);
+                    }
+                });
+        for (auto& x : th)
+            x.join();
+
+        size_t backwards = 0;
+        for (auto it = l.rbegin(); it != l.rend(); --it)
+            ++backwards;
+        TEST_ASSERT(to_vector(l).size() == l.size());
+        TEST_ASSERT(backwards == l.size());
+    }
+    std::cout << "PASSED: test_hot_front_churn" << std::endl;
+}
+
+static void
+test_concurrent_lru_cache()
+{
+    std::cout << "Running test_concurrent_lru_cache..." << std::endl;
+    ConcurrentLruCache<int, std::string> cache(3, 4);
+    cache.put(1, "one");
+    cache.put(2, "two");
+    cache.put(3, "three");
+    TEST_ASSERT(cache.size() == 3);
+
+    // touching 1 makes 2 the eviction candidate
+    TEST_ASSERT(cache.get(1) == "one");
+    cache.put(4, "four");
+    TEST_ASSERT(cache.size() == 3);
+    TEST_ASSERT(!cache.contains(2));
+    TEST_ASSERT(cache.get(2) == std::nullopt);
+    TEST_ASSERT(cache.get(3) == "three");
+
+    cache.put(1, "uno");
+    TEST_ASSERT(cache.get(1) == "uno");
+    TEST_ASSERT(cache.size() == 3);
+
+    TEST_ASSERT(cache.erase(4));
+    TEST_ASSERT(!cache.erase(4));
+    TEST_ASSERT(cache.size() == 2);
+
+    ConcurrentLruCache<int, int> shared(64);
+    std::vector<std::thread>     th;
+    for (int t = 0; t < 4; ++t)
+        th.emplace_back(
+            [&shared, t]()
+            {
+                std::mt19937 rng(t);
+                for (int i = 0; i < 2000; ++i)
+                {
+                    const int key = static_cast<int>(rng() % 128);
+                    if (auto v = shared.get(key))
+                        TEST_ASSERT(*v == key * 10);
+                    else
+                        shared.put(key, key * 10);
+                }
+            });
+    for (auto& x : th)
+        x.join();
+
+    TEST_ASSERT(shared.size() <= 64);
+
+    // a cache much smaller than its key set keeps every hit's move_to_front
+    // racing the evictions at the other end of a short list
+    ConcurrentLruCache<int, int> hot(8, 2);
+    th.clear();
+    for (int t = 0; t < 4; ++t)
+        th.emplace_back(
+            [&hot, t]()
+            {
+                std::mt19937 rng(t);
+                for (int i = 0; i < 5000; ++i)
+                {
+                    const int key = static_cast<int>(rng() % 16);
+                    if (auto v = hot.get(key))
+                        TEST_ASSERT(*v == key);
+                    else
+                        hot.put(key, key);
+                }
+            });
+    for (auto& x : th)
+        x.join();
+
+    TEST_ASSERT(hot.size() <= 8);
+
+    // puts of new keys racing past the capacity evict one entry each, so
+    // the cache ends up full rather than drained below it
+    ConcurrentLruCache<int, int> full(64);
+    th.clear();
+    for (int t = 0; t < 4; ++t)
+        th.emplace_back(
+            [&full, t]()
+            {
+                for (int i = 0; i < 1000; ++i)
+                    full.put(t * 1000 + i, i);
+            });
+    for (auto& x : th)
+        x.join();
+
+    TEST_ASSERT(full.size() == 64);
+    std::cout << "PASSED: test_concurrent_lru_cache" << std::endl;
+}
+
+static void
+test_iteration_during_removal()
+{
+    std::cout << "Running test_iteration_during_removal..." << std::endl;
+    List<int> l;
+    for (int i = 0; i < 2000; ++i)
+        l.push_back(i);
+
+    std::atomic<bool>        done{false};
+    std::vector<std::thread> th;
+    for (int t = 0; t < 2; ++t)
+        th.emplace_back(
+            [&l]()
+            {
+                for (int i = 0; i < 900; ++i)
+                    (i % 2 ? l.pop_front() : l.pop_back());
+            });
+
+    // readers step over in-flight removals and must keep seeing an ordered,
+    // terminating sequence
+    for (int t = 0; t < 2; ++t)
+        th.emplace_back(
+            [&l, &done]()
+            {
+                while (!done.load(std::memory_order_acquire))
+                {
+                    int last = -1;
+                    for (auto it = l.begin(); it != l.end(); ++it)
+                    {
+                        TEST_ASSERT(*it > last);
+                        last = *it;
+                    }
+                    for (auto it = l.rbegin(); it != l.end(); --it)
+                    {
+                        TEST_ASSERT(last == -1 || *it <= last);
+                        last = *it;
+                    }
+                }
+            });
+
+    th[0].join();
+    th[1].join();
+    done.store(true, std::memory_order_release);
+    th[2].join();
+    th[3].join();
+
+    TEST_ASSERT(l.size() == 200);
+    TEST_ASSERT(to_vector(l).size() == 200);
+    std::cout << "PASSED: test_iteration_during_removal" << std::endl;
+}
+
+static void
+test_work_stealing_list()
+{
+    std::cout << "Running test_work_stealing_list..." << std::endl;
+    WorkStealingList<std::string> w;
+    TEST_ASSERT(w.empty());
+    TEST_ASSERT(!w.pop_back());
+    TEST_ASSERT(!w.steal());
+
+    w.push_back(std::string("a"));
+    w.push_back(std::string("b"));
+    w.push_back(std::string("c"));
+    TEST_ASSERT(w.size() == 3);
+    TEST_ASSERT(w.pop_back() == "c");
+    TEST_ASSERT(w.steal() == "a");
+    TEST_ASSERT(w.pop_back() == "b");
+    TEST_ASSERT(w.empty());
+    w.push_back(std::string("left for the destructor"));
+
+    // a value whose construction throws leaves the deque as it was
+    struct Picky
+    {
+        explicit Picky(int v)
+            : value(v)
+        {
+            if (v < 0)
+                throw std::invalid_argument("negative");
+        }
+
+        int value;
+    };
+
+    WorkStealingList<Picky> picky;
+    picky.push_back(1);
+    bool threw = false;
+    try
+    {
+        picky.push_back(-1);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    TEST_ASSERT(threw);
+    TEST_ASSERT(picky.size() == 1);
+    picky.push_back(2);
+    TEST_ASSERT(picky.pop_back()->value == 2);
+    TEST_ASSERT(picky.steal()->value == 1);
+    TEST_ASSERT(picky.empty());
+
+    // every pushed item is taken exactly once, by the owner or a thief
+    constexpr int                 kItems = 20000;
+    WorkStealingList<int>         shared;
+    std::vector<std::atomic<int>> taken(kItems);
+    std::atomic<bool>             done{false};
+    std::vector<std::thread>      thieves;
+    for (int t = 0; t < 3; ++t)
+        thieves.emplace_back(
+            [&]()
+            {
+                while (!done.load(std::memory_order_acquire) || !shared.empty())
+                {
+                    if (auto v = shared.steal())
+                        taken[*v].fetch_add(1);
+                }
+            });
+
+    for (int i = 0; i < kItems; ++i)
+    {
+        shared.push_back(i);
+        if (i % 3 == 0)
+        {
+            if (auto v = shared.pop_back())
+                taken[*v].fetch_add(1);
+        }
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& x : thieves)
+        x.join();
+
+    for (int i = 0; i < kItems; ++i)
+        TEST_ASSERT(taken[i].load() == 1);
+    std::cout << "PASSED: test_work_stealing_list" << std::endl;
+}
+
+template<Concurrency Model>
+static void
+run_producers_consumers(int producers, int consumers)
+{
+    constexpr int                         kPerProducer = 5000;
+    const int                             total        = producers * kPerProducer;
+    List<int, std::allocator<int>, Model> l;
+    std::atomic<int>                      popped{0};
+    std::atomic<long>                     sum{0};
+    std::vector<std::thread>              th;
+
+    for (int p = 0; p < producers; ++p)
+        th.emplace_back(
+            [&l, p]()
+            {
+                for (int i = 0; i < kPerProducer; ++i)
+                    l.push_back(p * kPerProducer + i);
+            });
+
+    for (int c = 0; c < consumers; ++c)
+        th.emplace_back(
+            [&]()
+            {
+                int last = -1;
+                while (popped.load() < total)
+                {
+                    auto it = l.pop_front();
+                    if (it == l.end())
+                        continue;
+                    // a single producer's items come out in push order
+                    if (producers == 1 && consumers == 1)
+                        TEST_ASSERT(*it == last + 1);
+                    last = *it;
+                    sum.fetch_add(*it);
+                    popped.fetch_add(1);
+                }
+            });
+
+    for (auto& x : th)
+        x.join();
+
+    TEST_ASSERT(popped.load() == total);
+    TEST_ASSERT(sum.load() == static_cast<long>(total) * (total - 1) / 2);
+    TEST_ASSERT(l.empty());
+    TEST_ASSERT(l.size() == 0);
+}
+
+static void
+test_concurrency_models()
+{
+    std::cout << "Running test_concurrency_models..." << std::endl;
+    static_assert(List<int>::concurrency() == Concurrency::MPMC);
+    static_assert(pmr::List<int, Concurrency::SPSC>::concurrency() == Concurrency::SPSC);
+
+    List<int, std::allocator<int>, Concurrency::SPSC> l;
+    l.push_back(2);
+    l.push_front(1);
+    l.push_back(3);
+    TEST_ASSERT(l.size() == 3);
+    TEST_ASSERT(*l.pop_back() == 3);
+    TEST_ASSERT(*l.pop_front() == 1);
+    TEST_ASSERT(l.size() == 1);
+    l.clear();
+    TEST_ASSERT(l.empty() && l.size() == 0);
+
+    run_producers_consumers<Concurrency::SPSC>(1, 1);
+    run_producers_consumers<Concurrency::MPSC>(3, 1);
+    run_producers_consumers<Concurrency::SPMC>(1, 3);
+    run_producers_consumers<Concurrency::MPMC>(3, 3);
+
+    // the single consumer takes its end node straight off the sentinel;
+    // producers at both ends race it on both sentinel links
+    {
+        constexpr int                                     kPerProducer = 5000;
+        List<int, std::allocator<int>, Concurrency::MPSC> both;
+        std::vector<std::thread>                          th;
+        for (int p = 0; p < 2; ++p)
+            th.emplace_back(
+                [&both, p]()
+                {
+                    for (int i = 0; i < kPerProducer; ++i)
+                    {
+                        const int v = p * kPerProducer + i;
+                        if (i & 1)
+                            both.push_front(v);
+                        else
+                            both.push_back(v);
+                    }
+                });
+
+        std::vector<int> seen(2 * kPerProducer, 0);
+        for (int popped = 0, i = 0; popped < 2 * kPerProducer; ++i)
+        {
+            auto it = (i & 1) ? both.pop_back() : both.pop_front();
+            if (it == both.end())
+                continue;
+            ++seen[*it];
+            ++popped;
+        }
+        for (auto& x : th)
+            x.join();
+
+        TEST_ASSERT(std::count(seen.begin(), seen.end(), 1) == 2 * kPerProducer);
+        TEST_ASSERT(both.empty() && both.size() == 0);
+    }
+    std::cout << "PASSED: test_concurrency_models" << std::endl;
+}
+
+// Runs posted continuations when drained, like an event loop turn.
+struct QueueExecutor
+{
+    template<typename Fn>
+    void
+    execute(Fn fn)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.emplace_back(std::move(fn));
+    }
+
+    size_t
+    drain()
+    {
+        std::deque<std::function<void()>> batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            batch.swap(queue);
+        }
+        for (auto& fn : batch)
+            fn();
+        return batch.size();
+    }
+
+    std::mutex                        mutex;
+    std::deque<std::function<void()>> queue;
+};
+
+// Fire-and-forget coroutine: starts eagerly and frees itself at the end.
+struct DetachedTask
+{
+    struct promise_type
+    {
+        DetachedTask
+        get_return_object()
+        {
+            return {};
+        }
+
+        std::suspend_never
+        initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never
+        final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void
+        return_void()
+        {
+        }
+
+        void
+        unhandled_exception()
+        {
+            std::terminate();
+        }
+    };
+};
+
+static DetachedTask
+consume_one(List<int>& l, QueueExecutor& ex, std::atomic<int>& out)
+{
+    auto it = co_await l.pop_front_async(ex);
+    out.store(*it);
+}
+
+static DetachedTask
+consume_batch(List<int>& l, QueueExecutor& ex, size_t max, std::atomic<int>& count)
+{
+    auto items = co_await l.pop_front_async(ex, max);
+    TEST_ASSERT(!items.empty() && items.size() <= max);
+    count.fetch_add(static_cast<int>(items.size()));
+}
+
+static DetachedTask
+consume_loop(List<int>& l, QueueExecutor& ex, int n, std::atomic<long>& sum)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        auto it = co_await l.pop_front_async(ex);
+        sum.fetch_add(*it);
+    }
+}
+
+static void
+test_pop_front_async()
+{
+    std::cout << "Running test_pop_front_async..." << std::endl;
+    List<int>     l;
+    QueueExecutor ex;
+
+    // an available element completes the await without the executor
+    std::atomic<int> got{-1};
+    l.push_back(1);
+    consume_one(l, ex, got);
+    TEST_ASSERT(got.load() == 1);
+    TEST_ASSERT(ex.drain() == 0);
+
+    // an empty list parks the coroutine until a push
+    consume_one(l, ex, got);
+    TEST_ASSERT(ex.drain() == 0 && got.load() == 1);
+    l.push_back(2);
+    TEST_ASSERT(l.empty());
+    TEST_ASSERT(ex.drain() == 1 && got.load() == 2);
+
+    std::atomic<int> count{0};
+    for (int i = 0; i < 5; ++i)
+        l.push_back(i);
+    consume_batch(l, ex, 3, count);
+    TEST_ASSERT(count.load() == 3 && l.size() == 2);
+    consume_batch(l, ex, 3, count);
+    TEST_ASSERT(count.load() == 5 && l.empty());
+    consume_batch(l, ex, 3, count);
+    l.push_front(9);
+    TEST_ASSERT(ex.drain() == 1 && count.load() == 6);
+
+    // parked consumers are fed by producers on other threads
+    constexpr int            kConsumers = 4;
+    constexpr int            kEach      = 500;
+    std::atomic<long>        sum{0};
+    std::atomic<bool>        done{false};
+    std::vector<std::thread> th;
+    for (int c = 0; c < kConsumers; ++c)
+        consume_loop(l, ex, kEach, sum);
+    for (int p = 0; p < 2; ++p)
+        th.emplace_back(
+            [&l, p]()
+            {
+                for (int i = 0; i < kConsumers * kEach / 2; ++i)
+                    l.push_back(p * kConsumers * kEach / 2 + i);
+            });
+    th.emplace_back(
+        [&ex, &done]()
+        {
+            while (!done.load())
+                ex.drain();
+        });
+
+    th[0].join();
+    th[1].join();
+    constexpr long kTotal = kConsumers * kEach;
+    while (sum.load() != kTotal * (kTotal - 1) / 2)
+        std::this_thread::yield();
+    done.store(true);
+    th[2].join();
+    ex.drain();
+
+    TEST_ASSERT(l.empty());
+    std::cout << "PASSED: test_pop_front_async" << std::endl;
+}
+
+static void
+test_clear_detach()
+{
+    std::cout << "Running test_clear_detach..." << std::endl;
+    CountingResource res;
+    {
+        pmr::List<int> l(&res);
+        for (int i = 0; i < 1000; ++i)
+            l.push_back(i);
+
+        auto mid = l.begin();
+        for (int i = 0; i < 500; ++i)
+            ++mid;
+
+        l.clear();
+        TEST_ASSERT(l.empty());
+        TEST_ASSERT(l.size() == 0);
+
+        // the pinned node outlives the clear and reads as removed
+        TEST_ASSERT(*mid == 500);
+        TEST_ASSERT(l.erase(mid) == l.end());
+        TEST_ASSERT(!l.move_to_front(mid));
+
+        l.push_back(1);
+        TEST_ASSERT(to_vector(l) == std::vector<int>{1});
+        mid = {};
+        EpochDomain::Instance().Barrier();
+        TEST_ASSERT(res.outstanding.load() == 2);
+
+        // pushes racing a clear land either in the detached chain or in the
+        // new list, never in between
+        std::atomic<bool>        done{false};
+        std::vector<std::thread> th;
+        for (int t = 0; t < 2; ++t)
+            th.emplace_back(
+                [&l]()
+                {
+                    for (int i = 0; i < 2000; ++i)
+                        (i % 2 ? l.push_back(i) : l.push_front(i));
+                });
+        th.emplace_back(
+            [&l, &done]()
+            {
+                while (!done.load(std::memory_order_acquire))
+                {
+                    l.pop_front();
+                    for (auto it = l.begin(); it != l.end(); ++it)
+                        ;
+                }
+            });
+        for (int i = 0; i < 50; ++i)
+            (i % 2 ? l.clear() : l.clear_async());
+        th[0].join();
+        th[1].join();
+        done.store(true, std::memory_order_release);
+        th[2].join();
+
+        l.clear();
+        TEST_ASSERT(l.size() == 0);
+        for (int i = 0; i < 100; ++i)
+            l.push_back(i);
+        l.clear_async();
+        l.push_back(7);
+        TEST_ASSERT(l.size() == 1);
+        TEST_ASSERT(to_vector(l) == std::vector<int>{7});
+    }
+    TEST_ASSERT(res.outstanding.load() == 0);
+    std::cout << "PASSED: test_clear_detach" << std::endl;
+}
+
+static void
+test_node_handle()
+{
+    std::cout << "Running test_node_handle..." << std::endl;
+    CountingResource res;
+    {
+        pmr::List<int> a(&res);
+        pmr::List<int> b(&res);
+        for (int i = 0; i < 5; ++i)
+            a.push_back(i);
+        const auto allocated = res.allocations.load();
+
+        auto h = a.pop_front_node();
+        TEST_ASSERT(!h.empty() && h.value() == 0);
+        b.insert(b.end(), std::move(h));
+        TEST_ASSERT(h.empty());
+
+        auto it = a.begin();
+        ++it;
+        auto pinned = it;
+        h           = a.extract(it);
+        TEST_ASSERT(h && h.value() == 2);
+        TEST_ASSERT(!a.extract(pinned));
+        TEST_ASSERT(a.erase(pinned) != pinned);
+        h.value() = 20;
+        auto in   = b.insert(b.begin(), std::move(h));
+        TEST_ASSERT(*in == 20 && *pinned == 20);
+
+        // a position that disappears forwards the insert to its successor
+        auto pos = b.begin();
+        ++pos;
+        b.erase(pos);
+        b.insert(pos, a.pop_back_node());
+
+        TEST_ASSERT((to_vector(a) == std::vector<int>{1, 3}));
+        TEST_ASSERT((to_vector(b) == std::vector<int>{20, 4}));
+        TEST_ASSERT(a.size() == 2 && b.size() == 2);
+        TEST_ASSERT(res.allocations.load() == allocated);
+
+        TEST_ASSERT(!b.pop_front_node().empty());
+        TEST_ASSERT(!b.pop_front_node().empty());
+        TEST_ASSERT(b.pop_front_node().empty());
+        TEST_ASSERT(b.insert(b.end(), pmr::List<int>::node_handle()) == b.end());
+
+        // shuttle nodes between two lists from several threads
+        for (int i = 0; i < 1000; ++i)
+            b.push_back(i);
+        std::vector<std::thread> th;
+        for (int t = 0; t < 4; ++t)
+            th.emplace_back(
+                [&a, &b, t]()
+                {
+                    auto& from = t % 2 ? a : b;
+                    auto& to   = t % 2 ? b : a;
+                    for (int i = 0; i < 2000; ++i)
+                        if (auto n = from.pop_front_node())
+                            to.insert(to.end(), std::move(n));
+                });
+        for (auto& x : th)
+            x.join();
+        TEST_ASSERT(a.size() + b.size() == 1002);
+        TEST_ASSERT(to_vector(a).size() + to_vector(b).size() == 1002);
+    }
+    TEST_ASSERT(res.outstanding.load() == 0);
+    std::cout << "PASSED: test_node_handle" << std::endl;
+}
+
+static void
+test_reserve()
+{
+    std::cout << "Running test_reserve..." << std::endl;
+    CountingResource res;
+    {
+        pmr::List<int> l(&res);
+        l.reserve(100, ReservePolicy::Fail);
+        // whole pages are mapped, so the reserve may round up
+        const size_t capacity = l.reserve_available();
+        TEST_ASSERT(capacity >= 100);
+
+        const auto allocated = res.allocations.load();
+        for (size_t i = 0; i < capacity; ++i)
+            l.push_back(static_cast<int>(i));
+        TEST_ASSERT(res.allocations.load() == allocated);
+        TEST_ASSERT(l.reserve_available() == 0);
+
+        bool threw = false;
+        try
+        {
+            l.push_back(-1);
+        }
+        catch (const std::bad_alloc&)
+        {
+            threw = true;
+        }
+        TEST_ASSERT(threw);
+        TEST_ASSERT(l.size() == capacity);
+
+        // an erased node is recycled once its grace period is over
+        l.pop_front();
+        l.push_back(-1);
+        TEST_ASSERT(l.back() == -1);
+
+        l.reserve(capacity, ReservePolicy::Grow);
+        for (size_t i = 0; i < capacity; ++i)
+            l.push_front(static_cast<int>(i));
+        TEST_ASSERT(l.size() == 2 * capacity);
+        TEST_ASSERT(res.allocations.load() == allocated);
+    }
+    TEST_ASSERT(res.outstanding.load() == 0);
+
+    // a blocked producer waits for the consumer to hand nodes back
+    List<int> l;
+    l.reserve(1, ReservePolicy::Block);
+    const size_t     capacity = l.reserve_available();
+    std::atomic<int> consumed{0};
+    std::thread      consumer(
+        [&l, &consumed, capacity]()
+        {
+            while (consumed.load() < static_cast<int>(4 * capacity))
+                if (l.pop_front() != l.end())
+                    consumed.fetch_add(1);
+        });
+    for (size_t i = 0; i < 4 * capacity; ++i)
+        l.push_back(static_cast<int>(i));
+    consumer.join();
+    TEST_ASSERT(l.empty());
+
+    // pooled nodes may outlive the list that reserved them
+    List<int>::iterator survivor;
+    {
+        List<int> scoped;
+        scoped.reserve(4);
+        scoped.push_back(42);
+        survivor = scoped.pop_front();
+    }
+    TEST_ASSERT(*survivor == 42);
+    std::cout << "PASSED: test_reserve" << std::endl;
+}
+
+static void
+test_insert_splice()
+{
+    std::cout << "Running test_insert_splice..." << std::endl;
+    List<int> l;
+    l.push_back(1);
+    auto four = l.push_back(4);
+    TEST_ASSERT(*l.insert(four, 2) == 2);
+    const std::vector<int> three{3};
+    TEST_ASSERT(*l.insert(four, three.begin(), three.end()) == 3);
+    TEST_ASSERT(l.insert(four, three.end(), three.end()) == four);
+    TEST_ASSERT((to_vector(l) == std::vector<int>{1, 2, 3, 4}));
+
+    // a removed position forwards the insert to its successor
+    auto two = l.begin();
+    ++two;
+    l.erase(two);
+    l.insert(two, 20);
+    TEST_ASSERT((to_vector(l) == std::vector<int>{1, 20, 3, 4}));
+
+    std::istringstream in("5 6 7");
+    l.insert(l.end(), std::istream_iterator<int>(in), std::istream_iterator<int>());
+    TEST_ASSERT((to_vector(l) == std::vector<int>{1, 20, 3, 4, 5, 6, 7}));
+    TEST_ASSERT(l.size() == 7);
+
+    // readers see a range either not at all or complete
+    constexpr int            kBatch = 64;
+    std::atomic<bool>        done{false};
+    std::vector<std::thread> th;
+    th.emplace_back(
+        [&l, &done]()
+        {
+            while (!done.load(std::memory_order_acquire))
+            {
+                int batch = 0;
+                for (auto it = l.begin(); it != l.end(); ++it)
+                    batch += *it >= 1000;
+                TEST_ASSERT(batch % kBatch == 0);
+            }
+        });
+    std::vector<int> values(kBatch);
+    for (int round = 0; round < 50; ++round)
+    {
+        for (int i = 0; i < kBatch; ++i)
+            values[i] = 1000 + round * kBatch + i;
+        auto pos = l.begin();
+        for (int i = 0; i < round % 7; ++i)
+            ++pos;
+        l.insert(pos, values.begin(), values.end());
+    }
+    done.store(true, std::memory_order_release);
+    th[0].join();
+    th.clear();
+    TEST_ASSERT(l.size() == 7 + 50 * kBatch);
+
+    // per-thread staging lists merged into a shared one without allocating
+    CountingResource res;
+    {
+        pmr::List<int>                               shared(&res);
+        std::vector<std::unique_ptr<pmr::List<int>>> staging;
+        for (int t = 0; t < 4; ++t)
+            staging.push_back(std::make_unique<pmr::List<int>>(&res));
+        const auto allocated = res.allocations.load() + 4 * 500;
+
+        for (int t = 0; t < 4; ++t)
+            th.emplace_back(
+                [&shared, &staging, t]()
+                {
+                    auto& mine = *staging[t];
+                    for (int round = 0; round < 5; ++round)
+                    {
+                        for (int i = 0; i < 100; ++i)
+                            mine.push_back(t * 1000 + round * 100 + i);
+                        shared.splice(shared.end(), mine);
+                        TEST_ASSERT(mine.empty());
+                    }
+                });
+        for (auto& x : th)
+            x.join();
+        TEST_ASSERT(res.allocations.load() == allocated);
+        TEST_ASSERT(shared.size() == 2000);
+
+        // each splice kept its elements together and in order
+        auto v = to_vector(shared);
+        for (size_t i = 0; i < v.size(); i += 100)
+            for (size_t j = 1; j < 100; ++j)
+                TEST_ASSERT(v[i + j] == v[i] + static_cast<int>(j));
+
+        auto& other = *staging[0];
+        auto  it    = other.push_back(-1);
+        TEST_ASSERT(shared.splice(shared.begin(), other, it));
+        auto gone = other.push_back(-2);
+        other.erase(gone);
+        TEST_ASSERT(!shared.splice(shared.begin(), other, gone));
+        TEST_ASSERT(shared.front() == -1 && other.empty());
+        TEST_ASSERT(shared.size() == 2001);
+    }
+    TEST_ASSERT(res.outstanding.load() == 0);
+    std::cout << "PASSED: test_insert_splice" << std::endl;
+}
+
+static void
+test_merge()
+{
+    std::cout << "Running test_merge..." << std::endl;
+    // ordered by key only, so ties show which list an element came from
+    struct Record
+    {
+        int key;
+        int source;
+    };
+    auto byKey = [](const Record& a, const Record& b) { return a.key < b.key; };
+
+    CountingResource res;
+    {
+        pmr::List<Record> a(&res);
+        pmr::List<Record> b(&res);
+        for (int i = 0; i < 10; ++i)
+        {
+            a.push_back(Record{i * 2, 0});
+            b.push_back(Record{i * 3, 1});
+        }
+        auto pinned    = b.begin();
+        auto allocated = res.allocations.load();
+
+        a.merge(b, byKey);
+        TEST_ASSERT(res.allocations.load() == allocated);
+        TEST_ASSERT(b.empty() && b.size() == 0);
+        TEST_ASSERT(a.size() == 20);
+        TEST_ASSERT(pinned->key == 0 && pinned->source == 1);
+
+        Record last{-1, 0};
+        for (auto it = a.begin(); it != a.end(); ++it)
+        {
+            TEST_ASSERT(it->key > last.key || (it->key == last.key && it->source >= last.source));
+            last = *it;
+        }
+        TEST_ASSERT(a.front().source == 0 && a.back().key == 27);
+
+        // both lists stay usable
+        b.push_back(Record{5, 1});
+        a.merge(b, byKey);
+        a.pop_front();
+        TEST_ASSERT(a.size() == 20 && b.empty());
+    }
+    TEST_ASSERT(res.outstanding.load() == 0);
+
+    // k-way merge of shards split across workers
+    constexpr int                              kShards = 5;
+    constexpr int                              kEach   = 6000;
+    List<Record>                               merged;
+    std::vector<std::unique_ptr<List<Record>>> shards;
+    std::vector<List<Record>*>                 inputs;
+    std::mt19937                               rng(7);
+    for (int i = 0; i < kEach; i += 3)
+        merged.push_back(Record{i, 0});
+    for (int s = 0; s < kShards; ++s)
+    {
+        shards.push_back(std::make_unique<List<Record>>());
+        inputs.push_back(shards.back().get());
+        int key = 0;
+        for (int i = 0; i < kEach; ++i)
+        {
+            key += static_cast<int>(rng() % 3);
+            shards.back()->push_back(Record{key, s + 1});
+        }
+    }
+
+    merged.merge(inputs, byKey, 4);
+    TEST_ASSERT(merged.size() == static_cast<size_t>(kEach / 3 + kShards * kEach));
+    size_t count = 0;
+    Record last{-1, 0};
+    for (auto it = merged.begin(); it != merged.end(); ++it, ++count)
+    {
+        TEST_ASSERT(it->key > last.key || (it->key == last.key && it->source >= last.source));
+        last = *it;
+    }
+    TEST_ASSERT(count == merged.size());
+    for (auto& shard : shards)
+        TEST_ASSERT(shard->empty() && shard->begin() == shard->end());
+
+    for (int i = 0; i < 100; ++i)
+        merged.pop_back();
+    TEST_ASSERT(merged.size() == count - 100);
+
+    // a list named twice, and the target itself, are merged once
+    List<Record>               target;
+    List<Record>               twice;
+    std::vector<List<Record>*> repeated{&twice, &target, &twice};
+    for (int i = 0; i < 4; ++i)
+    {
+        target.push_back(Record{2 * i, 0});
+        twice.push_back(Record{2 * i + 1, 1});
+    }
+    target.merge(repeated, byKey, 1);
+    TEST_ASSERT(target.size() == 8);
+    TEST_ASSERT(twice.empty());
+    int expected = 0;
+    for (auto it = target.begin(); it != target.end(); ++it)
+        TEST_ASSERT(it->key == expected++);
+    TEST_ASSERT(expected == 8);
+    std::cout << "PASSED: test_merge" << std::endl;
+}
+
+static void
+test_dump_load()
+{
+    std::cout << "Running test_dump_load..." << std::endl;
+    const std::string path =
+        (std::filesystem::temp_directory_path() / ("lockfree_list_test." + std::to_string(::getpid()) + ".snapshot"))
+            .string();
+
+    struct Sample
+    {
+        int    id;
+        double weight;
+    };
+    List<Sample> samples;
+    for (int i = 0; i < 100000; ++i)
+        samples.push_back(Sample{i, i * 0.5});
+    TEST_ASSERT(samples.dump(path) == 100000);
+
+    List<Sample> restored;
+    restored.push_back(Sample{-1, 0});
+    TEST_ASSERT(restored.load(path) == 100000);
+    TEST_ASSERT(restored.size() == 100001);
+    restored.pop_front();
+    int expected = 0;
+    for (auto it = restored.begin(); it != restored.end(); ++it, ++expected)
+        TEST_ASSERT(it->id == expected && it->weight == expected * 0.5);
+    TEST_ASSERT(expected == 100000);
+
+    // a mismatching element type is rejected
+    bool threw = false;
+    try
+    {
+        List<int> wrong;
+        wrong.load(path);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    TEST_ASSERT(threw);
+
+    // so is another type of the same size
+    struct Swapped
+    {
+        double weight;
+        int    id;
+    };
+    static_assert(sizeof(Swapped) == sizeof(Sample));
+    threw = false;
+    try
+    {
+        List<Swapped> wrong;
+        wrong.load(path);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    TEST_ASSERT(threw);
+
+    // variable-size elements go through a serializer
+    List<std::string> words;
+    for (const char* w : {"alpha", "", "gamma", "a longer element than the rest"})
+        words.push_back(w);
+    words.dump(path, [](const std::string& w, std::string& out) { out += w; });
+
+    List<std::string> read;
+    read.load(path,
+              [](std::span<const std::byte> bytes)
+              { return std::string(reinterpret_cast<const char*>(bytes.data()), bytes.size()); });
+    std::vector<std::string> got;
+    for (auto it = read.begin(); it != read.end(); ++it)
+        got.push_back(*it);
+    TEST_ASSERT((got == std::vector<std::string>{"alpha", "", "gamma", "a longer element than the rest"}));
+
+    // a failed dump leaves the previous snapshot in place
+    threw = false;
+    try
+    {
+        words.dump(path, [](const std::string&, std::string&) { throw std::runtime_error("serializer"); });
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    TEST_ASSERT(threw);
+    List<std::string> again;
+    TEST_ASSERT(again.load(path,
+                           [](std::span<const std::byte> bytes)
+                           { return std::string(reinterpret_cast<const char*>(bytes.data()), bytes.size()); }) == 4);
+
+    std::ifstream leftover(path + ".tmp");
+    TEST_ASSERT(!leftover);
+    std::remove(path.c_str());
+    std::cout << "PASSED: test_dump_load" << std::endl;
+}
+
+static void
+test_producer()
+{
+    std::cout << "Running test_producer..." << std::endl;
+    List<int> l;
+    {
+        auto p = l.producer(4, std::chrono::hours(1));
+        p.push_back(1);
+        p.push_back(2);
+        p.push_back(3);
+        TEST_ASSERT(l.empty() && p.pending() == 3);
+        p.emplace_back(4);
+        TEST_ASSERT(p.pending() == 0);
+        TEST_ASSERT((to_vector(l) == std::vector<int>{1, 2, 3, 4}));
+
+        p.push_back(5);
+        p.flush();
+        p.push_back(6);
+        TEST_ASSERT(l.size() == 5);
+    }
+    TEST_ASSERT((to_vector(l) == std::vector<int>{1, 2, 3, 4, 5, 6}));
+
+    // an elapsed delay publishes on the next push
+    {
+        auto p = l.producer(1000, std::chrono::microseconds(0));
+        p.push_back(7);
+        TEST_ASSERT(p.pending() == 0 && l.size() == 7);
+    }
+
+    // batches from concurrent producers stay contiguous and in order
+    constexpr int            kThreads   = 4;
+    constexpr int            kBatch     = 16;
+    constexpr int            kPerThread = kBatch * 250;
+    List<int>                shared;
+    std::vector<std::thread> th;
+    for (int t = 0; t < kThreads; ++t)
+        th.emplace_back(
+            [&shared, t]()
+            {
+                auto p = shared.producer(kBatch, std::chrono::hours(1));
+                for (int i = 0; i < kPerThread; ++i)
+                    p.push_back(t * kPerThread + i);
+            });
+    for (auto& x : th)
+        x.join();
+
+    const std::vector<int> all = to_vector(shared);
+    TEST_ASSERT(all.size() == kThreads * kPerThread);
+    for (std::size_t i = 0; i < all.size(); i += kBatch)
+        for (int j = 1; j < kBatch; ++j)
+            TEST_ASSERT(all[i + j] == all[i] + j);
+    std::cout << "PASSED: test_producer" << std::endl;
+}
+
+static void
+test_memory_stats()
+{
+    std::cout << "Running test_memory_stats..." << std::endl;
+    List<int> l;
+    for (int i = 0; i < 1000; ++i)
+        l.push_back(i);
+    MemoryStats stats = l.memory_stats();
+    TEST_ASSERT(stats.linked == 1000 && stats.nodes == 1000);
+    TEST_ASSERT(stats.pinned == 0 && stats.retired == 0);
+    TEST_ASSERT(stats.nodeBytes > 1000 * sizeof(int));
+    TEST_ASSERT(stats.peakNodes == 1000 && stats.peakLinked == 1000);
+    TEST_ASSERT(stats.reserveBytes == 0);
+
+    // an iterator on an erased element keeps it alive until it lets go
+    {
+        auto first = l.begin();
+        l.erase(first);
+        auto nh = l.pop_front_node();
+        stats   = l.memory_stats();
+        TEST_ASSERT(stats.linked == 998 && stats.pinned == 2 && stats.nodes == 1000);
+    }
+    stats = l.memory_stats();
+    TEST_ASSERT(stats.pinned == 0 && stats.nodes == stats.linked + stats.retired);
+    EpochDomain::Instance().Barrier();
+    stats = l.memory_stats();
+    TEST_ASSERT(stats.nodes == 998 && stats.retired == 0);
+
+    l.clear();
+    EpochDomain::Instance().Barrier();
+    stats = l.memory_stats();
+    TEST_ASSERT(stats.nodes == 0 && stats.linked == 0);
+    TEST_ASSERT(stats.peakNodes == 1000 && stats.peakBytes > stats.nodeBytes);
+
+    l.reserve(100);
+    TEST_ASSERT(l.memory_stats().reserveBytes >= 100 * sizeof(int));
+
+    // moved nodes are charged to the list they move into
+    {
+        List<int> a;
+        List<int> b;
+        for (int i = 0; i < 10; ++i)
+            b.push_back(i);
+        a.splice(a.end(), b);
+        a.splice(a.end(), b);
+        b.push_back(10);
+        auto nh = b.extract(b.begin());
+        a.insert(a.end(), std::move(nh));
+        List<int> c;
+        c.push_back(-1);
+        a.merge(c);
+        EpochDomain::Instance().Barrier();
+        const MemoryStats as = a.memory_stats();
+        const MemoryStats bs = b.memory_stats();
+        TEST_ASSERT(as.linked == 12 && as.nodes == 12 && as.pinned == 0);
+        TEST_ASSERT(bs.linked == 0 && bs.nodes == 0 && bs.pinned == 0);
+        TEST_ASSERT(c.memory_stats().nodes == 0);
+    }
+
+    // nodes pinned past the list keep its accounting alive
+    List<int>::iterator kept;
+    {
+        List<int> tmp;
+        tmp.push_back(1);
+        kept = tmp.begin();
+    }
+    kept = List<int>::iterator();
+
+    // handles from a dead list move into another one while the dead list's
+    // last pinned nodes are freed on this thread: its accounting is
+    // released exactly once, by whichever side gets there last
+    for (int round = 0; round < 100; ++round)
+    {
+        std::vector<List<int>::node_handle> handles;
+        std::vector<List<int>::iterator>    pins;
+        {
+            List<int> dead;
+            for (int i = 0; i < 8; ++i)
+                dead.push_back(i);
+            for (int i = 0; i < 4; ++i)
+                handles.push_back(dead.pop_front_node());
+            for (auto it = dead.begin(); it != dead.end(); ++it)
+                pins.push_back(it);
+        }
+        std::thread mover(
+            [&l, &handles]()
+            {
+                for (auto& nh : handles)
+                    l.insert(l.end(), std::move(nh));
+            });
+        pins.clear();
+        EpochDomain::Instance().Barrier();
+        mover.join();
+        for (int i = 0; i < 4; ++i)
+            l.pop_back();
+    }
+    EpochDomain::Instance().Barrier();
+    TEST_ASSERT(l.memory_stats().nodes == l.memory_stats().linked);
+
+    constexpr int            kThreads = 4;
+    std::vector<std::thread> th;
+    for (int t = 0; t < kThreads; ++t)
+        th.emplace_back(
+            [&l]()
+            {
+                for (int i = 0; i < 10000; ++i)
+                {
+                    l.push_back(i);
+                    if (i % 2)
+                        l.pop_front();
+                }
+            });
+    for (auto& x : th)
+        x.join();
+    EpochDomain::Instance().Barrier();
+    stats = l.memory_stats();
+    TEST_ASSERT(stats.linked == kThreads * 5000 && stats.nodes == stats.linked);
+    TEST_ASSERT(stats.peakNodes >= stats.nodes && stats.peakNodes <= kThreads * 10000);
+    std::cout << "PASSED: test_memory_stats" << std::endl;
+}
+
+static void
+test_replace_update()
+{
+    std::cout << "Running test_replace_update..." << std::endl;
+    List<int> l;
+    for (int i = 1; i <= 3; ++i)
+        l.push_back(i);
+
+    auto second = l.begin();
+    ++second;
+    auto twenty = l.replace(second, 20);
+    TEST_ASSERT(twenty != l.end() && *twenty == 20);
+    TEST_ASSERT((to_vector(l) == std::vector<int>{1, 20, 3}));
+    TEST_ASSERT(l.replace(second, 30) == l.end());
+    TEST_ASSERT(l.update(second, [](int v) { return v + 1; }) == l.end());
+
+    // the ends are swapped like any other element
+    auto first = l.update(l.begin(), [](int v) { return v * 10; });
+    auto last  = l.end();
+    --last;
+    l.replace(last, 30);
+    l.update(twenty, [](int v) { return v + 1; });
+    TEST_ASSERT((to_vector(l) == std::vector<int>{10, 21, 30}));
+    TEST_ASSERT(*first == 10 && l.size() == 3);
+    TEST_ASSERT(l.replace(l.end(), 0) == l.end());
+
+    // readers see every key exactly once and in order while writers swap
+    // versions; no update is lost
+    struct Versioned
+    {
+        int key;
+        int version;
+    };
+    constexpr int            kKeys    = 64;
+    constexpr int            kWriters = 3;
+    List<Versioned>          v;
+    std::atomic<bool>        done{false};
+    std::atomic<int>         updates{0};
+    std::vector<std::thread> th;
+    for (int k = 0; k < kKeys; ++k)
+        v.push_back(Versioned{k, 0});
+
+    th.emplace_back(
+        [&v, &done]()
+        {
+            while (!done.load(std::memory_order_acquire))
+            {
+                int expected = 0;
+                for (auto it = v.begin(); it != v.end(); ++it)
+                    TEST_ASSERT(it->key == expected++);
+                TEST_ASSERT(expected == kKeys);
+            }
+        });
+    for (int w = 0; w < kWriters; ++w)
+        th.emplace_back(
+            [&v, &updates, w]()
+            {
+                std::mt19937 rng(w);
+                for (int i = 0; i < 3000; ++i)
+                {
+                    auto it = v.begin();
+                    for (int n = rng() % kKeys; n > 0; --n)
+                        ++it;
+                    if (v.update(it, [](const Versioned& old) { return Versioned{old.key, old.version + 1}; }) !=
+                        v.end())
+                        updates.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+    for (std::size_t t = 1; t < th.size(); ++t)
+        th[t].join();
+    done.store(true, std::memory_order_release);
+    th[0].join();
+
+    int versions = 0;
+    for (auto it = v.begin(); it != v.end(); ++it)
+        versions += it->version;
+    TEST_ASSERT(versions == updates.load() && updates.load() > 0);
+    TEST_ASSERT(v.size() == kKeys);
+    std::cout << "PASSED: test_replace_update" << std::endl;
+}
+
+static void
+test_cursor()
+{
+    std::cout << "Running test_cursor..." << std::endl;
+    List<int> l;
+    for (int i = 0; i < 5; ++i)
+        l.push_back(i * 10);
+
+    auto c = l.cursor(l.begin());
+    TEST_ASSERT(*c == 0 && !c.at_end());
+    TEST_ASSERT(c.advance(2) == 2 && *c == 20);
+    c.insert_after(21);
+    c.insert_after(22);
+    TEST_ASSERT(*c == 22);
+    c.insert_before(19);
+    TEST_ASSERT((to_vector(l) == std::vector<int>{0, 10, 20, 21, 19, 22, 30, 40}));
+    TEST_ASSERT(l.size() == 8);
+
+    TEST_ASSERT(c.retreat() == 1 && *c == 19);
+    TEST_ASSERT(c.erase_current() && *c == 22);
+    TEST_ASSERT(c.advance(10) == 3 && c.at_end());
+    TEST_ASSERT(!c.erase_current());
+    c.insert_before(50);
+    TEST_ASSERT(c.retreat() == 1 && *c == 50);
+    TEST_ASSERT(c.retreat(100) == 8 && c.at_end());
+
+    // the cursor moves off elements removed or replaced under it
+    auto d = l.cursor(l.begin());
+    l.erase(l.begin());
+    d.insert_after(5);
+    TEST_ASSERT(*d == 5 && *d.position() == 5);
+    TEST_ASSERT((to_vector(l) == std::vector<int>{10, 5, 20, 21, 22, 30, 40, 50}));
+    l.replace(d.position(), 6);
+    d.insert_after(7);
+    TEST_ASSERT((to_vector(l) == std::vector<int>{10, 6, 7, 20, 21, 22, 30, 40, 50}));
+
+    // at the end there is no successor: insert_after appends
+    auto e = l.cursor(l.end());
+    e.insert_after(60);
+    e.insert_after(70);
+    TEST_ASSERT(*e == 70 && !e.at_end());
+    TEST_ASSERT((to_vector(l) == std::vector<int>{10, 6, 7, 20, 21, 22, 30, 40, 50, 60, 70}));
+    TEST_ASSERT(l.size() == 11);
+
+    // an element spliced away leaves the cursor at the end of its own list,
+    // and its edits stay there
+    List<int> from;
+    List<int> into;
+    from.push_back(1);
+    from.push_back(2);
+    auto f = from.cursor(from.begin());
+    auto g = from.cursor(++from.begin());
+    into.splice(into.end(), from);
+    TEST_ASSERT(!g.erase_current() && g.at_end());
+    f.insert_before(3);
+    TEST_ASSERT(f.at_end());
+    f.insert_after(4);
+    TEST_ASSERT(*f == 4);
+    TEST_ASSERT((to_vector(into) == std::vector<int>{1, 2}) && into.size() == 2);
+    TEST_ASSERT((to_vector(from) == std::vector<int>{3, 4}) && from.size() == 2);
+
+    // each thread builds its own run behind its own anchor while others
+    // erase around them
+    constexpr int kThreads = 4;
+    constexpr int kRun     = 2000;
+    List<int>     runs;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        runs.push_back(-1);
+        for (int i = 0; i < 100; ++i)
+            runs.push_back(-2);
+    }
+
+    std::vector<std::thread> th;
+    for (int t = 0; t < kThreads; ++t)
+        th.emplace_back(
+            [&runs, t]()
+            {
+                auto it = runs.begin();
+                for (int anchors = 0; *it != -1 || anchors++ < t;)
+                    ++it;
+                auto cur = runs.cursor(it);
+                for (int i = 0; i < kRun; ++i)
+                    cur.insert_after(t * kRun + i);
+            });
+    th.emplace_back(
+        [&runs]()
+        {
+            for (int n = 0; n < kThreads * 100;)
+                for (auto it = runs.begin(); it != runs.end(); ++it)
+                    if (*it == -2)
+                    {
+                        runs.erase(it);
+                        ++n;
+                    }
+        });
+    for (auto& x : th)
+        x.join();
+
+    std::vector<int> seen = to_vector(runs);
+    std::vector<int> expected;
+    for (int t = 0; t < kThreads; ++t)
+    {
+        expected.push_back(-1);
+        for (int i = 0; i < kRun; ++i)
+            expected.push_back(t * kRun + i);
+    }
+    TEST_ASSERT(seen == expected);
+    std::cout << "PASSED: test_cursor" << std::endl;
+}
+
+static void
+test_scan_from_both_ends()
+{
+    std::cout << "Running test_scan_from_both_ends..." << std::endl;
+    constexpr int kElements = 20000;
+    List<int>     l;
+    for (int i = 0; i < kElements; ++i)
+        l.push_back(i);
+
+    std::vector<int> front;
+    std::vector<int> back;
+    const auto [nFront, nBack] =
+        l.scan_from_both_ends([&front](int v) { front.push_back(v); }, [&back](int v) { back.push_back(v); });
+    TEST_ASSERT(nFront == front.size() && nBack == back.size());
+    TEST_ASSERT(nFront + nBack == kElements);
+    // the front walker sees a prefix, the back walker the rest in reverse
+    std::vector<int> seen(front);
+    seen.insert(seen.end(), back.rbegin(), back.rend());
+    TEST_ASSERT(seen == to_vector(l));
+
+    // a nested scan finds the slot taken and walks everything itself
+    List<int> small;
+    for (int i = 0; i < 3; ++i)
+        small.push_back(i);
+    std::size_t nested = 0;
+    small.scan_from_both_ends(
+        [&small, &nested](int)
+        {
+            if (!nested)
+                nested = small.scan_from_both_ends([](int) {}, [](int) {}).first;
+        },
+        [](int) {});
+    TEST_ASSERT(nested == 3);
+
+    List<int> empty;
+    TEST_ASSERT(empty.scan_from_both_ends([](int) {}, [](int) {}) == std::make_pair(std::size_t{0}, std::size_t{0}));
+
+    // splits in any order, including duplicates and end()
+    std::vector<List<int>::iterator> splits;
+    for (auto it = l.begin(); it != l.end(); ++it)
+        if (*it % 3001 == 7)
+            splits.push_back(it);
+    std::reverse(splits.begin(), splits.end());
+    splits.push_back(splits.front());
+    splits.push_back(l.end());
+
+    std::vector<std::atomic<int>> hits(kElements);
+    TEST_ASSERT(l.parallel_for_each(splits, [&hits](int v) { hits[v].fetch_add(1); }) == kElements);
+    for (const auto& h : hits)
+        TEST_ASSERT(h.load() == 1);
+
+    // stable elements are visited exactly once while churn elements around
+    // them, the walkers' meeting points included, come and go
+    List<int> mixed;
+    for (int i = 0; i < kElements; ++i)
+    {
+        mixed.push_back(i);
+        mixed.push_back(-1);
+    }
+
+    std::atomic<bool> stop{false};
+    std::thread       churn(
+        [&mixed, &stop]()
+        {
+            while (!stop.load())
+            {
+                for (auto it = mixed.begin(); it != mixed.end(); ++it)
+                    if (*it < 0)
+                    {
+                        mixed.insert(it, -1);
+                        mixed.erase(it);
+                    }
+            }
+        });
+
+    for (int round = 0; round < 20; ++round)
+    {
+        for (auto& h : hits)
+            h.store(0);
+        auto count = [&hits](int v)
+        {
+            if (v >= 0)
+                hits[v].fetch_add(1);
+        };
+
+        if (round % 2)
+        {
+            mixed.scan_from_both_ends(count, count);
+        }
+        else
+        {
+            std::vector<List<int>::iterator> cuts;
+            for (auto it = mixed.begin(); it != mixed.end(); ++it)
+                if (*it >= 0 && *it % 5000 == 0)
+                    cuts.push_back(it);
+            mixed.parallel_for_each(cuts, count);
+        }
+        for (const auto& h : hits)
+            TEST_ASSERT(h.load() == 1);
+    }
+    stop.store(true);
+    churn.join();
+    std::cout << "PASSED: test_scan_from_both_ends" << std::endl;
+}
+
+// steady clock the test moves by hand
+struct ManualClock
+{
+    using rep        = long;
+    using period     = std::milli;
+    using duration   = std::chrono::milliseconds;
+    using time_point = std::chrono::time_point<ManualClock>;
+
+    static constexpr bool is_steady = true;
+
+    static time_point
+    now()
+    {
+        return time_point(duration(ticks.load()));
+    }
+
+    static inline std::atomic<long> ticks{0};
+};
+
+static void
+test_expiring_list()
+{
+    std::cout << "Running test_expiring_list..." << std::endl;
+    using namespace std::chrono_literals;
+
+    ExpiringList<int, ManualClock> l(100ms);
+    for (int i = 0; i < 10; ++i)
+        l.push_back(i);
+    ManualClock::ticks += 50;
+    for (int i = 10; i < 20; ++i)
+        l.push_back(i);
+    TEST_ASSERT(l.size() == 20);
+
+    // expired elements are skipped until they are swept
+    ManualClock::ticks += 50;
+    std::vector<int> seen;
+    for (auto it = l.begin(); it != l.end(); ++it)
+        seen.push_back(*it);
+    std::vector<int> alive(10);
+    std::iota(alive.begin(), alive.end(), 10);
+    TEST_ASSERT(seen == alive);
+    seen.clear();
+    l.for_each([&seen](int v) { seen.push_back(v); });
+    TEST_ASSERT(seen == alive);
+    TEST_ASSERT(l.size() == 20);
+
+    TEST_ASSERT(l.sweep(4) == 4 && l.size() == 16);
+    TEST_ASSERT(l.sweep() == 6 && l.size() == 10);
+    TEST_ASSERT(l.sweep() == 0 && l.size() == 10);
+    TEST_ASSERT(l.pop_front() == 10);
+
+    // a short TTL behind a long one is skipped but not swept
+    ExpiringList<int, ManualClock> mixed(100ms);
+    mixed.push_back(1);
+    mixed.push_back(2, 10ms);
+    mixed.push_back(3);
+    ManualClock::ticks += 20;
+    TEST_ASSERT(mixed.begin() != mixed.end() && *mixed.begin() == 1 && *++mixed.begin() == 3);
+    TEST_ASSERT(mixed.sweep() == 0 && mixed.size() == 3);
+    TEST_ASSERT(mixed.pop_front() == 1 && mixed.pop_front() == 3 && !mixed.pop_front());
+
+    // a reader on the popped element still finds its value there
+    ExpiringList<std::string, ManualClock> words(100ms);
+    words.push_back(std::string(64, 'x'));
+    auto reader = words.begin();
+    TEST_ASSERT(words.pop_front() == std::string(64, 'x'));
+    TEST_ASSERT(*reader == std::string(64, 'x'));
+
+    // pushes sweep up to two expired elements each
+    ExpiringList<int, ManualClock> amortized(10ms, 2);
+    for (int i = 0; i < 5; ++i)
+        amortized.push_back(i);
+    ManualClock::ticks += 10;
+    amortized.push_back(5);
+    TEST_ASSERT(amortized.size() == 4);
+    amortized.push_back(6);
+    amortized.push_back(7);
+    TEST_ASSERT(amortized.size() == 3 && amortized.pop_front() == 5);
+
+    // the background sweeper empties the front while readers never see an
+    // expired element
+    ExpiringList<int, ManualClock> background(10ms);
+    for (int i = 0; i < 1000; ++i)
+        background.push_back(i);
+    ManualClock::ticks += 10;
+    for (int i = 0; i < 10; ++i)
+        background.push_back(-1, 1h);
+    background.start_sweeper(1ms, 16);
+    for (int i = 0; i < 2000 && background.size() > 10; ++i)
+    {
+        background.for_each([](int v) { TEST_ASSERT(v == -1); });
+        std::this_thread::sleep_for(1ms);
+    }
+    background.stop_sweeper();
+    TEST_ASSERT(background.size() == 10);
+    std::cout << "PASSED: test_expiring_list" << std::endl;
+}
+
+#ifdef LOCKFREE_LIST_TRACE
+static void
+test_trace()
+{
+    std::cout << "Running test_trace..." << std::endl;
+    List<int>                l;
+    std::vector<std::thread> th;
+    for (int t = 0; t < 4; ++t)
+        th.emplace_back(
+            [&l]()
+            {
+                for (int i = 0; i < 1000; ++i)
+                {
+                    l.push_back(i);
+                    l.pop_front();
+                }
+            });
+    for (auto& x : th)
+        x.join();
+
+    std::ostringstream out;
+    TraceLog::Instance().WriteChrome(out);
+    const std::string json = out.str();
+    TEST_ASSERT(json.starts_with("{\"traceEvents\":["));
+    TEST_ASSERT(json.find("\"name\":\"Insert\",\"ph\":\"B\"") != std::string::npos);
+    TEST_ASSERT(json.find("\"name\":\"Remove\",\"ph\":\"E\"") != std::string::npos);
+    TEST_ASSERT(json.find("\"cat\":\"m_prev\"") != std::string::npos);
+    TEST_ASSERT(json.ends_with("]}\n"));
+    std::cout << "PASSED: test_trace" << std::endl;
+}
+#endif
+
 int
 main()
 {
@@ -600,6 +2673,32 @@ main()
         test_concurrent_push_pop();
         test_concurrent_mixed_operations();
         test_concurrent_iteration();
+        test_flat_combining();
+        test_custom_allocator();
+        test_numa_list();
+        test_arena_list();
+        test_move_to_front();
+        test_hot_front_churn();
+        test_concurrent_lru_cache();
+        test_iteration_during_removal();
+        test_work_stealing_list();
+        test_concurrency_models();
+        test_pop_front_async();
+        test_clear_detach();
+        test_node_handle();
+        test_reserve();
+        test_insert_splice();
+        test_merge();
+        test_dump_load();
+        test_producer();
+        test_memory_stats();
+        test_replace_update();
+        test_cursor();
+        test_scan_from_both_ends();
+        test_expiring_list();
+#ifdef LOCKFREE_LIST_TRACE
+        test_trace();
+#endif
     }
     catch (const std::exception& ex)
     {
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "epoch_domain.hpp"
+
+// Memory held by a list's nodes, as reported by List::memory_stats().
+// Counts are of nodes; bytes cover the whole node, payload and links, but
+// not what the payload allocates on its own.
+struct MemoryStats
+{
+    std::size_t linked       = 0;  // reachable from the list
+    std::size_t pinned       = 0;  // unlinked, kept alive by iterators, node handles or producers
+    std::size_t retired      = 0;  // unreachable, waiting for their grace period
+    std::size_t nodes        = 0;  // all of the above
+    std::size_t nodeBytes    = 0;  // including the sentinel
+    std::size_t reserveBytes = 0;  // mapped by reserve(), used or not
+    std::size_t peakLinked   = 0;
+    std::size_t peakNodes    = 0;
+    std::size_t peakBytes    = 0;
+};
+
+// Counts the nodes a list has allocated. Threads count into one of a few
+// shards, so the hot path stays on a cache line the thread mostly has to
+// itself; a shard hands its count on to the shared total once it has
+// drifted by a batch, and that is where the peak is taken. It can miss
+// spikes shorter than a batch per shard.
+//
+// Pinned nodes outlive their list, so the counts do too. The block keeps a
+// plain count of its live nodes plus one for the owner, which hands its
+// share to the epoch domain when it dies; nodes are freed, and moved to
+// other lists, from any thread, so only the decrement that takes that
+// count to zero frees the block.
+class NodeAccounting : public EpochDomain::Retired
+{
+public:
+    struct Counts
+    {
+        std::size_t nodes;
+        std::size_t retired;
+        std::size_t peakNodes;
+    };
+
+    NodeAccounting() = default;
+
+    NodeAccounting(const NodeAccounting&) = delete;
+    NodeAccounting&
+    operator=(const NodeAccounting&) = delete;
+
+    // True when the shard published its batch, a hint for the caller to
+    // sample peaks of its own.
+    bool
+    CountAllocated()
+    {
+        m_live.fetch_add(1, std::memory_order_relaxed);
+        return Add(Mine().nodes, 1);
+    }
+
+    void
+    CountRetired()
+    {
+        Mine().retired.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // `retired` for nodes that were freed through the epoch domain
+    void
+    CountFreed(bool retired)
+    {
+        Shard& shard = Mine();
+        if (retired)
+            shard.retired.fetch_sub(1, std::memory_order_relaxed);
+        Add(shard.nodes, -1);
+        Release();
+    }
+
+    Counts
+    Read()
+    {
+        std::int64_t nodes   = m_nodes.load(std::memory_order_relaxed);
+        std::int64_t retired = 0;
+        for (const Shard& shard : m_shards)
+        {
+            nodes += shard.nodes.load(std::memory_order_relaxed);
+            retired += shard.retired.load(std::memory_order_relaxed);
+        }
+
+        const std::size_t n = nodes > 0 ? nodes : 0;
+        return Counts{n, retired > 0 ? static_cast<std::size_t>(retired) : 0, Raise(m_peakNodes, n)};
+    }
+
+    // Releases the owner's hold; pass to EpochDomain::Retire.
+    static void
+    Drop(EpochDomain::Retired* retired)
+    {
+        static_cast<NodeAccounting*>(retired)->Release();
+    }
+
+    // Returns the new peak.
+    static std::size_t
+    Raise(std::atomic<std::size_t>& peak, std::size_t value)
+    {
+        std::size_t current = peak.load(std::memory_order_relaxed);
+        while (current < value &&
+               !peak.compare_exchange_weak(current, value, std::memory_order_relaxed, std::memory_order_relaxed))
+        {
+        }
+        return std::max(current, value);
+    }
+
+private:
+    static constexpr std::size_t  kShards = 16;
+    static constexpr std::int64_t kBatch  = 64;
+
+    struct alignas(64) Shard
+    {
+        std::atomic<std::int64_t> nodes{0};
+        std::atomic<std::int64_t> retired{0};
+    };
+
+    void
+    Release()
+    {
+        if (m_live.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+
+    Shard&
+    Mine()
+    {
+        static std::atomic<unsigned>       threads{0};
+        static thread_local const unsigned index = threads.fetch_add(1, std::memory_order_relaxed) % kShards;
+        return m_shards[index];
+    }
+
+    bool
+    Add(std::atomic<std::int64_t>& pending, std::int64_t n)
+    {
+        const std::int64_t drift = pending.fetch_add(n, std::memory_order_relaxed) + n;
+        if (drift < kBatch && drift > -kBatch)
+            return false;
+
+        // whoever moves the drift also adds it to the total, so concurrent
+        // publishers of one shard cannot lose or double count
+        pending.fetch_sub(drift, std::memory_order_relaxed);
+        const std::int64_t total = m_nodes.fetch_add(drift, std::memory_order_relaxed) + drift;
+        if (total > 0)
+            Raise(m_peakNodes, static_cast<std::size_t>(total));
+        return true;
+    }
+
+    Shard                     m_shards[kShards];
+    std::atomic<std::int64_t> m_nodes{0};
+    std::atomic<std::size_t>  m_peakNodes{0};
+    // live nodes, plus one until the owner drops the block
+    std::atomic<std::int64_t> m_live{1};
+};
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// What a reserved pool does when every slot is in use.
+enum class ReservePolicy
+{
+    Fail,  // throw std::bad_alloc
+    Grow,  // map another chunk as large as everything reserved so far
+    Block  // wait until a slot is released
+};
+
+// Fixed-size slots carved out of mmap'ed chunks and recycled through a
+// tagged Treiber stack, so the steady state never enters the allocator.
+// Every slot starts with a one-word header in front of the memory handed
+// out: it links the slot into the stack while free and names its pool while
+// in use, which is how Owner() finds the pool without the caller storing
+// it. A stale read of the header by a losing pop only meets an atomic store,
+// never the object constructed behind it, and the tag makes the CAS that
+// follows fail. Chunks are only unmapped when the pool dies.
+//
+// The pool is shared by its owner and every slot handed out: it deletes
+// itself when the owner has dropped it and the last slot has come back.
+// Owners that defer frees pass a `flush` that pushes through what it can
+// without waiting; it runs on the allocating thread whenever the pool looks
+// exhausted, before the policy applies. Blocked allocations sleep until a
+// slot is released, waking now and then to flush again, since slots held
+// back by deferred frees only return once somebody flushes.
+class NodePool
+{
+public:
+    NodePool(std::size_t slotSize, std::size_t slotAlign, void (*flush)() = nullptr)
+        : m_offset(RoundUp(sizeof(Slot), slotAlign))
+        , m_slotSize(RoundUp(m_offset + slotSize, std::max(slotAlign, alignof(Slot))))
+        , m_flush(flush)
+    {
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool&
+    operator=(const NodePool&) = delete;
+
+    // Grows the pool to at least `slots` slots and switches the policy.
+    // Huge pages are best effort: without a hugetlbfs reservation the chunk
+    // falls back to normal pages with a transparent huge page hint.
+    void
+    Reserve(std::size_t slots, ReservePolicy policy, bool hugePages)
+    {
+        m_policy.store(policy, std::memory_order_release);
+
+        std::lock_guard<std::mutex> lock(m_chunkMutex);
+        if (slots > m_capacity.load(std::memory_order_relaxed))
+            AddChunk(slots - m_capacity.load(std::memory_order_relaxed), hugePages);
+    }
+
+    void*
+    Acquire()
+    {
+        Head head = m_free.load(std::memory_order_acquire);
+        for (;;)
+        {
+            if (!head.ptr)
+            {
+                Exhausted();
+                head = m_free.load(std::memory_order_acquire);
+                continue;
+            }
+
+            Slot* next = static_cast<Slot*>(head.ptr->link.load(std::memory_order_relaxed));
+            if (m_free.compare_exchange_weak(
+                    head, Head{next, head.tag + 1}, std::memory_order_acq_rel, std::memory_order_acquire))
+                break;
+        }
+
+        head.ptr->link.store(this, std::memory_order_relaxed);
+        m_refs.fetch_add(1, std::memory_order_relaxed);
+        return head.ptr + 1;
+    }
+
+    // The pool a slot handed out by Acquire() belongs to.
+    static NodePool&
+    Owner(void* p)
+    {
+        return *static_cast<NodePool*>(Header(p)->link.load(std::memory_order_relaxed));
+    }
+
+    void
+    Release(void* p)
+    {
+        Push(Header(p), 1);
+        // pairs with the waiter's count and recheck in Exhausted()
+        if (m_waiters.load(std::memory_order_seq_cst) != 0)
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+            m_released.notify_all();
+        }
+        Drop();
+    }
+
+    // the owner's reference
+    void
+    Drop()
+    {
+        if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+
+    std::size_t
+    capacity() const
+    {
+        return m_capacity.load(std::memory_order_acquire);
+    }
+
+    // exact only while the owner still holds its reference
+    std::size_t
+    available() const
+    {
+        const std::size_t inUse = m_refs.load(std::memory_order_acquire) - 1;
+        const std::size_t cap   = capacity();
+        return cap > inUse ? cap - inUse : 0;
+    }
+
+private:
+    // the next free slot while free, the pool while in use
+    struct Slot
+    {
+        std::atomic<void*> link{nullptr};
+    };
+
+    struct Head
+    {
+        Slot*         ptr;
+        std::uint64_t tag;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Head>);
+
+    static constexpr std::size_t kHugePage = std::size_t{2} << 20;
+    // how long a blocked allocation sleeps before it flushes again
+    static constexpr std::chrono::milliseconds kFlushInterval{1};
+
+    static constexpr std::size_t
+    RoundUp(std::size_t n, std::size_t align)
+    {
+        return (n + align - 1) / align * align;
+    }
+
+    static Slot*
+    Header(void* p)
+    {
+        return reinterpret_cast<Slot*>(static_cast<unsigned char*>(p) - sizeof(Slot));
+    }
+
+    ~NodePool()
+    {
+        for (const auto& chunk : m_chunks)
+            munmap(chunk.first, chunk.second);
+    }
+
+    void
+    Exhausted()
+    {
+        if (m_flush)
+        {
+            m_flush();
+            if (m_free.load(std::memory_order_acquire).ptr)
+                return;
+        }
+
+        switch (m_policy.load(std::memory_order_acquire))
+        {
+        case ReservePolicy::Fail:
+            throw std::bad_alloc();
+        case ReservePolicy::Grow:
+        {
+            std::lock_guard<std::mutex> lock(m_chunkMutex);
+            if (!m_free.load(std::memory_order_acquire).ptr)
+                AddChunk(std::max<std::size_t>(m_capacity.load(std::memory_order_relaxed), 1), m_huge);
+            return;
+        }
+        case ReservePolicy::Block:
+        {
+            m_waiters.fetch_add(1, std::memory_order_seq_cst);
+            {
+                std::unique_lock<std::mutex> lock(m_waitMutex);
+                m_released.wait_for(
+                    lock, kFlushInterval, [this]() { return m_free.load(std::memory_order_seq_cst).ptr != nullptr; });
+            }
+            m_waiters.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+        }
+    }
+
+    // caller holds m_chunkMutex
+    void
+    AddChunk(std::size_t slots, bool hugePages)
+    {
+        const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        std::size_t       len  = (slots * m_slotSize + page - 1) / page * page;
+        void*             p    = MAP_FAILED;
+        if (hugePages)
+        {
+            const std::size_t hugeLen = (len + kHugePage - 1) / kHugePage * kHugePage;
+            p = mmap(nullptr, hugeLen, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED)
+                len = hugeLen;
+        }
+        if (p == MAP_FAILED)
+        {
+            p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED)
+                throw std::bad_alloc();
+            if (hugePages)
+                madvise(p, len, MADV_HUGEPAGE);
+        }
+        m_chunks.emplace_back(p, len);
+        m_huge = hugePages;
+
+        // the whole chunk goes onto the stack with a single CAS
+        slots            = len / m_slotSize;
+        auto* const base = static_cast<unsigned char*>(p);
+        Slot*       first = nullptr;
+        for (std::size_t i = slots; i-- > 0;)
+        {
+            Slot* s = ::new (base + i * m_slotSize + m_offset - sizeof(Slot)) Slot;
+            s->link.store(first, std::memory_order_relaxed);
+            first = s;
+        }
+
+        m_capacity.fetch_add(slots, std::memory_order_release);
+        Push(first, slots);
+    }
+
+    // Pushes a chain of `count` slots linked through their headers.
+    void
+    Push(Slot* first, std::size_t count)
+    {
+        Slot* last = first;
+        while (--count)
+            last = static_cast<Slot*>(last->link.load(std::memory_order_relaxed));
+
+        Head head = m_free.load(std::memory_order_relaxed);
+        do
+        {
+            last->link.store(head.ptr, std::memory_order_relaxed);
+        } while (!m_free.compare_exchange_weak(
+            head, Head{first, head.tag + 1}, std::memory_order_seq_cst, std::memory_order_relaxed));
+    }
+
+    // from a slot's start to what Acquire() hands out, header included
+    const std::size_t m_offset;
+    const std::size_t m_slotSize;
+    void (*const m_flush)();
+    alignas(64) std::atomic<Head> m_free{Head{nullptr, 0}};
+    alignas(64) std::atomic<std::size_t> m_refs{1};
+    std::atomic<std::size_t>                   m_capacity{0};
+    std::atomic<ReservePolicy>                 m_policy{ReservePolicy::Grow};
+    std::mutex                                 m_chunkMutex;
+    std::vector<std::pair<void*, std::size_t>> m_chunks;
+    bool                                       m_huge = false;
+    std::atomic<int>                           m_waiters{0};
+    std::mutex                                 m_waitMutex;
+    std::condition_variable                    m_released;
+};
@@ -0,0 +1,406 @@
+#pragma once
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "lockfree_list.hpp"
+
+// CPU to NUMA node mapping. Read from sysfs by default; a simulated layout
+// can be installed to exercise the per-node paths on single-node machines.
+class NumaTopology
+{
+public:
+    static NumaTopology
+    Detect()
+    {
+        NumaTopology topo;
+        for (int node = 0;; ++node)
+        {
+            std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!in)
+                break;
+
+            std::string list;
+            std::getline(in, list);
+            topo.AddCpuList(node, list);
+            topo.m_nodes = node + 1;
+        }
+
+        if (topo.m_nodes == 0)
+            topo.m_nodes = 1;
+        return topo;
+    }
+
+    // every `cpusPerNode` consecutive CPUs form one node
+    static NumaTopology
+    Simulated(int nodes, int cpusPerNode)
+    {
+        NumaTopology topo;
+        topo.m_nodes     = nodes;
+        topo.m_simulated = true;
+        for (int cpu = 0; cpu < nodes * cpusPerNode; ++cpu)
+            topo.SetNode(cpu, cpu / cpusPerNode);
+        return topo;
+    }
+
+    int
+    nodes() const
+    {
+        return m_nodes;
+    }
+
+    bool
+    simulated() const
+    {
+        return m_simulated;
+    }
+
+    int
+    NodeOfCpu(int cpu) const
+    {
+        if (cpu < 0 || static_cast<std::size_t>(cpu) >= m_cpuNode.size())
+            return 0;
+        return m_cpuNode[cpu];
+    }
+
+    // Node of the calling thread: an explicit binding wins over the CPU the
+    // thread happens to run on.
+    int
+    CurrentNode() const
+    {
+        if (ThreadBinding() >= 0)
+            return ThreadBinding() % m_nodes;
+        if (m_nodes == 1)
+            return 0;
+        return NodeOfCpu(sched_getcpu());
+    }
+
+    // Pins the calling thread to a logical node for every NumaList it uses;
+    // -1 restores CPU based detection.
+    static void
+    BindThread(int node)
+    {
+        ThreadBinding() = node;
+    }
+
+private:
+    static int&
+    ThreadBinding()
+    {
+        static thread_local int node = -1;
+        return node;
+    }
+
+    void
+    SetNode(int cpu, int node)
+    {
+        if (static_cast<std::size_t>(cpu) >= m_cpuNode.size())
+            m_cpuNode.resize(cpu + 1, 0);
+        m_cpuNode[cpu] = node;
+    }
+
+    void
+    AddCpuList(int node, const std::string& list)
+    {
+        std::size_t pos = 0;
+        while (pos < list.size())
+        {
+            std::size_t end   = list.find(',', pos);
+            std::string range = list.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+            if (!range.empty())
+            {
+                const std::size_t dash  = range.find('-');
+                const int         first = std::stoi(range.substr(0, dash));
+                const int         last  = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; ++cpu)
+                    SetNode(cpu, node);
+            }
+
+            if (end == std::string::npos)
+                break;
+            pos = end + 1;
+        }
+    }
+
+    std::vector<int> m_cpuNode;
+    int              m_nodes     = 0;
+    bool             m_simulated = false;
+};
+
+// Hands out memory bound to one NUMA node. Chunks are mmap'ed and bound with
+// mbind(MPOL_PREFERRED); the pool resource layered on top recycles the
+// individual node-sized blocks.
+class NodeLocalResource : public std::pmr::memory_resource
+{
+public:
+    explicit NodeLocalResource(int node, bool bind)
+        : m_node(node)
+        , m_bind(bind)
+    {
+    }
+
+    ~NodeLocalResource() override
+    {
+        for (const auto& chunk : m_chunks)
+            munmap(chunk.first, chunk.second);
+    }
+
+    NodeLocalResource(const NodeLocalResource&) = delete;
+    NodeLocalResource&
+    operator=(const NodeLocalResource&) = delete;
+
+private:
+    static constexpr int kMpolPreferred = 1;
+
+    void*
+    do_allocate(std::size_t bytes, std::size_t) override
+    {
+        const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        const std::size_t len  = (bytes + page - 1) / page * page;
+        void*             p    = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+            throw std::bad_alloc();
+
+        if (m_bind && m_node >= 0)
+        {
+            // best effort: an unsupported policy just leaves first-touch;
+            // the mask grows with the node id, which can pass 63
+            constexpr std::size_t      kBits = sizeof(unsigned long) * 8;
+            std::vector<unsigned long> mask(static_cast<std::size_t>(m_node) / kBits + 1);
+            mask[m_node / kBits] |= 1ul << (m_node % kBits);
+            syscall(SYS_mbind, p, len, kMpolPreferred, mask.data(), mask.size() * kBits, 0);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_chunks.emplace_back(p, len);
+        return p;
+    }
+
+    void
+    do_deallocate(void* p, std::size_t, std::size_t) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto it = m_chunks.begin(); it != m_chunks.end(); ++it)
+        {
+            if (it->first == p)
+            {
+                munmap(it->first, it->second);
+                m_chunks.erase(it);
+                return;
+            }
+        }
+    }
+
+    bool
+    do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    int                                        m_node;
+    bool                                       m_bind;
+    std::mutex                                 m_mutex;
+    std::vector<std::pair<void*, std::size_t>> m_chunks;
+};
+
+// One pmr::List per NUMA node, each with its own sentinel and node-local
+// storage. Pushes go to the caller's node; pops try the local sub-list first
+// and steal from the other nodes round-robin when it is empty. Ordering is
+// FIFO/LIFO per node only.
+template<typename T>
+class NumaList
+{
+public:
+    using size_type = std::size_t;
+    using iterator  = typename pmr::List<T>::iterator;
+
+    struct Stats
+    {
+        std::uint64_t localOps  = 0;
+        std::uint64_t remoteOps = 0;
+        std::uint64_t steals    = 0;
+    };
+
+    explicit NumaList(NumaTopology topo = NumaTopology::Detect())
+        : m_topo(std::move(topo))
+    {
+        m_shards.reserve(m_topo.nodes());
+        for (int node = 0; node < m_topo.nodes(); ++node)
+            m_shards.push_back(std::make_unique<Shard>(node, !m_topo.simulated() && m_topo.nodes() > 1));
+    }
+
+    NumaList(const NumaList&) = delete;
+    NumaList&
+    operator=(const NumaList&) = delete;
+
+    iterator
+    push_back(const T& data)
+    {
+        return Local().list.push_back(data);
+    }
+
+    iterator
+    push_back(T&& data)
+    {
+        return Local().list.push_back(std::move(data));
+    }
+
+    iterator
+    push_front(const T& data)
+    {
+        return Local().list.push_front(data);
+    }
+
+    iterator
+    push_front(T&& data)
+    {
+        return Local().list.push_front(std::move(data));
+    }
+
+    // Returns the popped element and whether one was found.
+    std::pair<bool, iterator>
+    pop_front()
+    {
+        return Pop(
+            [](pmr::List<T>& l)
+            {
+                return l.pop_front();
+            });
+    }
+
+    std::pair<bool, iterator>
+    pop_back()
+    {
+        return Pop(
+            [](pmr::List<T>& l)
+            {
+                return l.pop_back();
+            });
+    }
+
+    size_type
+    size() const
+    {
+        size_type total = 0;
+        for (const auto& shard : m_shards)
+            total += shard->list.size();
+        return total;
+    }
+
+    bool
+    empty() const
+    {
+        for (const auto& shard : m_shards)
+        {
+            if (!shard->list.empty())
+                return false;
+        }
+        return true;
+    }
+
+    int
+    nodes() const
+    {
+        return m_topo.nodes();
+    }
+
+    pmr::List<T>&
+    sub_list(int node)
+    {
+        return m_shards[node]->list;
+    }
+
+    template<typename Fn>
+    void
+    for_each(Fn fn)
+    {
+        for (auto& shard : m_shards)
+        {
+            for (auto it = shard->list.begin(); it != shard->list.end(); ++it)
+                fn(*it);
+        }
+    }
+
+    Stats
+    stats() const
+    {
+        Stats s;
+        for (const auto& shard : m_shards)
+        {
+            s.localOps += shard->localOps.load(std::memory_order_relaxed);
+            s.remoteOps += shard->remoteOps.load(std::memory_order_relaxed);
+            s.steals += shard->steals.load(std::memory_order_relaxed);
+        }
+        return s;
+    }
+
+private:
+    struct alignas(64) Shard
+    {
+        Shard(int node, bool bind)
+            : chunks(node, bind)
+            , pool(&chunks)
+            , list(&pool)
+        {
+        }
+
+        NodeLocalResource                    chunks;
+        std::pmr::synchronized_pool_resource pool;
+        pmr::List<T>                         list;
+
+        alignas(64) std::atomic<std::uint64_t> localOps{0};
+        std::atomic<std::uint64_t>             remoteOps{0};
+        std::atomic<std::uint64_t>             steals{0};
+    };
+
+    Shard&
+    Local()
+    {
+        Shard& shard = *m_shards[m_topo.CurrentNode()];
+        shard.localOps.fetch_add(1, std::memory_order_relaxed);
+        return shard;
+    }
+
+    template<typename PopFn>
+    std::pair<bool, iterator>
+    Pop(PopFn pop)
+    {
+        const int node  = m_topo.CurrentNode();
+        const int nodes = m_topo.nodes();
+        for (int i = 0; i < nodes; ++i)
+        {
+            Shard& shard = *m_shards[(node + i) % nodes];
+            if (i == 0)
+                shard.localOps.fetch_add(1, std::memory_order_relaxed);
+            else
+                m_shards[node]->remoteOps.fetch_add(1, std::memory_order_relaxed);
+
+            if (shard.list.empty())
+                continue;
+
+            iterator it = pop(shard.list);
+            if (it != shard.list.end())
+            {
+                if (i != 0)
+                    m_shards[node]->steals.fetch_add(1, std::memory_order_relaxed);
+                return std::make_pair(true, std::move(it));
+            }
+        }
+
+        return std::make_pair(false, iterator());
+    }
+
+    NumaTopology                        m_topo;
+    std::vector<std::unique_ptr<Shard>> m_shards;
+};
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+
+// Hardware counters around a stretch of code, read through perf_event_open.
+// The counters follow the calling thread and are inherited by every thread
+// it starts while they are open, so a benchmark that spawns its workers in
+// between Start() and Stop() is counted as a whole once they are joined.
+// The counts of exited children are folded into the parent counter, and
+// PERF_EVENT_IOC_RESET does not clear that part, so each measurement needs
+// a PerfCounters of its own; Start() on a used one keeps counting on top of
+// the threads of earlier runs.
+// Only user space is counted, which an unprivileged process may do at the
+// default perf_event_paranoid level.
+//
+// Each counter is opened on its own and may be missing: containers often
+// block the syscall altogether, virtual machines tend to lack the cache
+// events, and the locked-instruction count needs a model specific event.
+// Counters the kernel multiplexes are scaled up to the full run.
+class PerfCounters
+{
+public:
+    enum Counter
+    {
+        Cycles,
+        Instructions,
+        L1dMisses,
+        LlcMisses,
+        LockedOps,
+        kCounters
+    };
+
+    PerfCounters()
+    {
+        for (int c = 0; c < kCounters; ++c)
+            m_fds[c] = Open(static_cast<Counter>(c));
+    }
+
+    ~PerfCounters()
+    {
+        for (int fd : m_fds)
+            if (fd >= 0)
+                close(fd);
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters&
+    operator=(const PerfCounters&) = delete;
+
+    bool
+    Available() const
+    {
+        for (int fd : m_fds)
+            if (fd >= 0)
+                return true;
+        return false;
+    }
+
+    // why the first counter that failed could not be opened
+    const std::string&
+    Error() const
+    {
+        return m_error;
+    }
+
+    void
+    Start()
+    {
+        for (int fd : m_fds)
+        {
+            if (fd < 0)
+                continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    void
+    Stop()
+    {
+        for (int fd : m_fds)
+            if (fd >= 0)
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    // Count since the last Start(); nothing if the counter is unavailable
+    // or never got scheduled.
+    std::optional<double>
+    Read(Counter c) const
+    {
+        struct
+        {
+            std::uint64_t value;
+            std::uint64_t enabled;
+            std::uint64_t running;
+        } r;
+
+        if (m_fds[c] < 0 || read(m_fds[c], &r, sizeof(r)) != static_cast<ssize_t>(sizeof(r)) || r.running == 0)
+            return std::nullopt;
+        return static_cast<double>(r.value) * r.enabled / r.running;
+    }
+
+    static const char*
+    Name(Counter c)
+    {
+        static constexpr const char* kNames[] = {"cycles", "instr", "L1d miss", "LLC miss", "locked"};
+        return kNames[c];
+    }
+
+private:
+    int
+    Open(Counter c)
+    {
+        perf_event_attr attr{};
+        attr.size           = sizeof(attr);
+        attr.disabled       = 1;
+        attr.inherit        = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        switch (c)
+        {
+        case Cycles:
+            attr.type   = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case Instructions:
+            attr.type   = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case L1dMisses:
+            attr.type   = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | PERF_COUNT_HW_CACHE_OP_READ << 8 |
+                          PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+            break;
+        case LlcMisses:
+            attr.type   = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_LL | PERF_COUNT_HW_CACHE_OP_READ << 8 |
+                          PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+            break;
+        case LockedOps:
+        {
+            const std::optional<std::uint64_t> raw = LockedOpsEvent();
+            if (!raw)
+                return -1;
+            attr.type   = PERF_TYPE_RAW;
+            attr.config = *raw;
+            break;
+        }
+        default:
+            return -1;
+        }
+
+        const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd < 0 && m_error.empty())
+            m_error = std::string(Name(c)) + ": " + std::strerror(errno);
+        return fd;
+    }
+
+    // There is no generic event for lock-prefixed instructions; these are
+    // the retired locked loads on Intel since Sandy Bridge and the
+    // non-speculative locks on AMD since Zen 2.
+    static std::optional<std::uint64_t>
+    LockedOpsEvent()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned eax = 0;
+        unsigned ebx = 0;
+        unsigned ecx = 0;
+        unsigned edx = 0;
+        if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx))
+            return std::nullopt;
+
+        char vendor[13] = {};
+        std::memcpy(vendor, &ebx, 4);
+        std::memcpy(vendor + 4, &edx, 4);
+        std::memcpy(vendor + 8, &ecx, 4);
+        if (std::strcmp(vendor, "GenuineIntel") == 0)
+            return 0x21d0;  // MEM_INST_RETIRED.LOCK_LOADS
+        if (std::strcmp(vendor, "AuthenticAMD") == 0)
+            return 0x0225;  // LS_LOCKS.NON_SPEC_LOCK
+#endif
+        return std::nullopt;
+    }
+
+    int         m_fds[kCounters];
+    std::string m_error;
+};
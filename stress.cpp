@@ -0,0 +1,702 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "lockfree_list.hpp"
+
+// Long randomized runs against List<int>, in four phases:
+//   history     many short rounds of concurrent deque operations, each
+//               recorded and checked for linearizability against a
+//               sequential std::deque
+//   hot front   rounds of erases and moves to the front next to pushes at
+//               the front and pops at the back of a short list, each under
+//               a watchdog that fails the run if the threads stop moving
+//   soak        a long mix of pushes, pops, inserts, erases and replaces
+//               with a reader walking the list, checked for lost or
+//               duplicated elements; relocations are left out, as a walk
+//               pinned on a moved element rightly meets others again
+//   throughput  the bench's mixed workload, reported against a stored
+//               baseline; timing on a shared machine is too noisy to fail
+//               on unless --enforce-baseline asks for it
+// The operation mix and the pauses between operations come from the seed;
+// a failure prints the seed, so the same schedule can be replayed.
+namespace
+{
+struct Options
+{
+    std::uint64_t seed            = 1;
+    int           threads         = 4;
+    int           rounds          = 2000;
+    int           roundOps        = 6;
+    int           soakOps         = 100000;
+    int           hotRounds       = 300;
+    int           hotOps          = 200;
+    int           watchdog        = 10;
+    int           benchOps        = 400000;
+    double        tolerance       = 0.25;
+    std::string   baseline        = "lockfree_list_stress.baseline";
+    bool          updateBaseline  = false;
+    bool          enforceBaseline = false;
+};
+
+// Reports a failed check; the phase returns its result so main() exits
+// only once every thread of the phase has been joined.
+bool
+Fail(const Options& opts, const std::string& what)
+{
+    std::cerr << "FAILED: " << what << "\nreplay with --seed=" << opts.seed << std::endl;
+    return false;
+}
+
+// Busy-waits, yields or does nothing before an operation, as the thread's
+// generator decides, to shake up the interleavings.
+void
+Pause(std::mt19937_64& rng)
+{
+    switch (rng() % 8)
+    {
+    case 0:
+        std::this_thread::yield();
+        break;
+    case 1:
+    case 2:
+        for (int spin = static_cast<int>(rng() % 256); spin > 0; --spin)
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        break;
+    default:
+        break;
+    }
+}
+
+std::mt19937_64
+Generator(const Options& opts, std::uint64_t stream, std::uint64_t thread)
+{
+    std::seed_seq seq{opts.seed, stream, thread};
+    return std::mt19937_64(seq);
+}
+
+// Threads of a round spin here until all of them arrived, so their
+// operations overlap as much as possible.
+class StartLine
+{
+public:
+    explicit StartLine(int threads)
+        : m_waiting(threads)
+    {
+    }
+
+    void
+    Arrive()
+    {
+        m_waiting.fetch_sub(1, std::memory_order_acq_rel);
+        while (m_waiting.load(std::memory_order_acquire) > 0)
+        {
+        }
+    }
+
+private:
+    std::atomic<int> m_waiting;
+};
+
+enum class OpKind
+{
+    PushFront,
+    PushBack,
+    PopFront,
+    PopBack
+};
+
+constexpr int kEmpty = -1;
+
+// One completed operation. Invocation and response are ticks of a shared
+// counter, so `a.response < b.invoke` means a finished before b started.
+struct Event
+{
+    OpKind        kind;
+    int           value;  // pushed or popped; kEmpty for a pop that found nothing
+    std::uint64_t invoke;
+    std::uint64_t response;
+};
+
+std::ostream&
+operator<<(std::ostream& out, const Event& e)
+{
+    static constexpr const char* kNames[] = {"push_front", "push_back", "pop_front", "pop_back"};
+    out << kNames[static_cast<int>(e.kind)] << "(";
+    if (e.value == kEmpty)
+        out << "empty";
+    else
+        out << e.value;
+    return out << ") [" << e.invoke << ", " << e.response << "]";
+}
+
+// Searches for an order of the events that respects real time and that a
+// sequential deque, started from `initial`, reproduces result by result
+// (Wing and Gong, with the explored states cached as in Lowe's variant).
+class LinearizabilityChecker
+{
+public:
+    LinearizabilityChecker(std::vector<Event> history, std::deque<int> initial)
+        : m_history(std::move(history))
+        , m_initial(std::move(initial))
+    {
+    }
+
+    bool
+    Check()
+    {
+        if (m_history.size() > 64)
+            return false;
+        m_seen.clear();
+        return Search(0, m_initial);
+    }
+
+private:
+    bool
+    Search(std::uint64_t done, const std::deque<int>& model)
+    {
+        const std::size_t n = m_history.size();
+        if (done == (n == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << n) - 1))
+            return true;
+        if (!m_seen.emplace(done, std::vector<int>(model.begin(), model.end())).second)
+            return false;
+
+        // only events invoked before the first pending response can go next
+        std::uint64_t horizon = std::numeric_limits<std::uint64_t>::max();
+        for (std::size_t i = 0; i < n; ++i)
+            if (!(done >> i & 1))
+                horizon = std::min(horizon, m_history[i].response);
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (done >> i & 1 || m_history[i].invoke > horizon)
+                continue;
+
+            std::deque<int> next = model;
+            if (Apply(m_history[i], next) && Search(done | std::uint64_t{1} << i, next))
+                return true;
+        }
+        return false;
+    }
+
+    static bool
+    Apply(const Event& e, std::deque<int>& model)
+    {
+        switch (e.kind)
+        {
+        case OpKind::PushFront:
+            model.push_front(e.value);
+            return true;
+        case OpKind::PushBack:
+            model.push_back(e.value);
+            return true;
+        case OpKind::PopFront:
+            if (model.empty())
+                return e.value == kEmpty;
+            if (model.front() != e.value)
+                return false;
+            model.pop_front();
+            return true;
+        case OpKind::PopBack:
+            if (model.empty())
+                return e.value == kEmpty;
+            if (model.back() != e.value)
+                return false;
+            model.pop_back();
+            return true;
+        }
+        return false;
+    }
+
+    std::vector<Event>                                  m_history;
+    std::deque<int>                                     m_initial;
+    std::set<std::pair<std::uint64_t, std::vector<int>>> m_seen;
+};
+
+bool
+RunHistories(const Options& opts)
+{
+    const int threads = std::min(opts.threads, 64 / opts.roundOps);
+    for (int round = 0; round < opts.rounds; ++round)
+    {
+        List<int>       l;
+        std::deque<int> initial;
+        std::mt19937_64 setup = Generator(opts, 0, round);
+        for (int i = static_cast<int>(setup() % 3); i > 0; --i)
+        {
+            l.push_back(1000000 + i);
+            initial.push_back(1000000 + i);
+        }
+
+        std::atomic<std::uint64_t>      clock{0};
+        StartLine                       start(threads);
+        std::vector<std::vector<Event>> events(threads);
+        std::vector<std::thread>        th;
+        for (int t = 0; t < threads; ++t)
+            th.emplace_back(
+                [&, t]()
+                {
+                    std::mt19937_64 rng = Generator(opts, round + 1, t);
+                    start.Arrive();
+                    for (int i = 0; i < opts.roundOps; ++i)
+                    {
+                        Pause(rng);
+                        Event e{static_cast<OpKind>(rng() % 4), t * 1000 + i, 0, 0};
+                        e.invoke = clock.fetch_add(1, std::memory_order_acq_rel);
+                        switch (e.kind)
+                        {
+                        case OpKind::PushFront:
+                            l.push_front(e.value);
+                            break;
+                        case OpKind::PushBack:
+                            l.push_back(e.value);
+                            break;
+                        case OpKind::PopFront:
+                        case OpKind::PopBack:
+                        {
+                            auto it  = e.kind == OpKind::PopFront ? l.pop_front() : l.pop_back();
+                            e.value = it == l.end() ? kEmpty : *it;
+                            break;
+                        }
+                        }
+                        e.response = clock.fetch_add(1, std::memory_order_acq_rel);
+                        events[t].push_back(e);
+                    }
+                });
+        for (auto& x : th)
+            x.join();
+
+        std::vector<Event> history;
+        for (const auto& v : events)
+            history.insert(history.end(), v.begin(), v.end());
+
+        LinearizabilityChecker checker(history, initial);
+        if (!checker.Check())
+        {
+            std::cerr << "round " << round << ", initial size " << initial.size() << "\n";
+            for (const Event& e : history)
+                std::cerr << "  " << e << "\n";
+            return Fail(opts, "history is not linearizable");
+        }
+    }
+    std::cout << "history     " << opts.rounds << " rounds of " << threads << "x" << opts.roundOps
+              << " ops linearizable" << std::endl;
+    return true;
+}
+
+// Operations near the front of a short list keep meeting each other: an
+// erase or move next to a removal of its neighbour, a push_front next to
+// both. A round that stops making progress for `watchdog` seconds is a
+// livelock, reported with its seed rather than left to the test timeout.
+// Afterwards the list has to read the same forwards, backwards and in
+// size(), with no value twice.
+bool
+RunHotFront(const Options& opts)
+{
+    for (int round = 0; round < opts.hotRounds; ++round)
+    {
+        List<int> l;
+        for (int i = 0; i < 16; ++i)
+            l.push_back(i);
+
+        std::atomic<long>        progress{0};
+        std::atomic<bool>        done{false};
+        StartLine                start(opts.threads);
+        std::vector<std::thread> th;
+        for (int t = 0; t < opts.threads; ++t)
+            th.emplace_back(
+                [&, t]()
+                {
+                    std::mt19937_64 rng = Generator(opts, 1u << 30, round * opts.threads + t);
+                    start.Arrive();
+                    for (int i = 0; i < opts.hotOps; ++i)
+                    {
+                        Pause(rng);
+                        auto it = l.begin();
+                        for (int n = static_cast<int>(rng() % 12); n > 0 && it != l.end(); --n)
+                            ++it;
+
+                        if (rng() % 2)
+                        {
+                            if (it != l.end())
+                                l.move_to_front(it);
+                            l.pop_back();
+                        }
+                        else if (it != l.end())
+                        {
+                            l.erase(it);
+                        }
+                        l.push_front((t + 1) * 1000000 + round * opts.hotOps + i);
+                        progress.fetch_add(1, std::memory_order_relaxed);
+                    }
+                });
+
+        std::thread watchdog(
+            [&]()
+            {
+                using Clock             = std::chrono::steady_clock;
+                long              seen  = -1;
+                Clock::time_point since = Clock::now();
+                while (!done.load(std::memory_order_acquire))
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    const long now = progress.load(std::memory_order_relaxed);
+                    if (now != seen)
+                    {
+                        seen  = now;
+                        since = Clock::now();
+                    }
+                    else if (Clock::now() - since > std::chrono::seconds(opts.watchdog))
+                    {
+                        // the stuck threads never return, so no cleanup
+                        std::cerr << "FAILED: hot front round " << round << " stalled after " << now << " of "
+                                  << opts.threads * opts.hotOps << " ops\nreplay with --seed=" << opts.seed
+                                  << std::endl;
+                        std::_Exit(EXIT_FAILURE);
+                    }
+                }
+            });
+        for (auto& x : th)
+            x.join();
+        done.store(true, std::memory_order_release);
+        watchdog.join();
+
+        std::unordered_set<int> seen;
+        for (int v : l)
+            if (!seen.insert(v).second)
+                return Fail(opts,
+                            "hot front round " + std::to_string(round) + " holds " + std::to_string(v) + " twice");
+        std::size_t backwards = 0;
+        for (auto it = l.rbegin(); it != l.rend(); --it)
+            ++backwards;
+        if (seen.size() != l.size() || backwards != l.size())
+            return Fail(opts,
+                        "hot front round " + std::to_string(round) + ": " + std::to_string(seen.size()) +
+                            " forwards, " + std::to_string(backwards) + " backwards, size() " +
+                            std::to_string(l.size()));
+    }
+    std::cout << "hot front   " << opts.hotRounds << " rounds of " << opts.threads << "x" << opts.hotOps
+              << " ops, none stalled" << std::endl;
+    return true;
+}
+
+// Every value enters the list once and leaves it at most once. Each thread
+// logs what it put in and what it took out; whatever is left at the end
+// has to make up the difference exactly.
+bool
+RunSoak(const Options& opts)
+{
+    List<int>                     l;
+    std::vector<std::vector<int>> added(opts.threads + 1);
+    std::vector<std::vector<int>> taken(opts.threads + 1);
+    for (int i = 0; i < 1000; ++i)
+    {
+        l.push_back(i);
+        added[opts.threads].push_back(i);
+    }
+
+    // the walker reports what it saw here and the workers stop early
+    std::atomic<bool>        stop{false};
+    std::atomic<bool>        failed{false};
+    std::string              failure;
+    std::atomic<long>        walks{0};
+    std::vector<std::thread> th;
+    for (int t = 0; t < opts.threads; ++t)
+        th.emplace_back(
+            [&, t]()
+            {
+                std::mt19937_64 rng  = Generator(opts, 1u << 31, t);
+                int             next = (t + 1) * 10000000;
+                auto            add  = [&]()
+                {
+                    added[t].push_back(next);
+                    return next++;
+                };
+                auto            take = [&](const List<int>::iterator& it)
+                {
+                    if (it != l.end())
+                        taken[t].push_back(*it);
+                };
+
+                for (int i = 0; i < opts.soakOps && !failed.load(std::memory_order_relaxed); ++i)
+                {
+                    Pause(rng);
+                    switch (rng() % 10)
+                    {
+                    case 0:
+                        l.push_front(add());
+                        break;
+                    case 1:
+                        l.push_back(add());
+                        break;
+                    case 2:
+                        take(l.pop_front());
+                        break;
+                    case 3:
+                        take(l.pop_back());
+                        break;
+                    default:
+                    {
+                        auto it = l.begin();
+                        for (int n = static_cast<int>(rng() % 32); n > 0 && it != l.end(); --n)
+                            ++it;
+                        if (it == l.end())
+                            break;
+
+                        const int old = *it;
+                        switch (rng() % 6)
+                        {
+                        case 0:
+                            l.insert(it, add());
+                            break;
+                        case 1:
+                            if (auto nh = l.extract(it))
+                                taken[t].push_back(nh.value());
+                            break;
+                        case 2:
+                            if (l.replace(it, next) != l.end())
+                            {
+                                taken[t].push_back(old);
+                                add();
+                            }
+                            break;
+                        case 3:
+                            if (l.update(it, [&](int) { return next; }) != l.end())
+                            {
+                                taken[t].push_back(old);
+                                add();
+                            }
+                            break;
+                        case 4:
+                        {
+                            auto c = l.cursor(it);
+                            c.insert_after(add());
+                            c.insert_after(add());
+                            break;
+                        }
+                        default:
+                            break;
+                        }
+                        break;
+                    }
+                    }
+                }
+            });
+
+    // a forward walk never meets the same element twice
+    th.emplace_back(
+        [&]()
+        {
+            std::unordered_set<int> seen;
+            while (!stop.load(std::memory_order_acquire))
+            {
+                seen.clear();
+                for (auto it = l.begin(); it != l.end(); ++it)
+                {
+                    if (!seen.insert(*it).second)
+                    {
+                        failure = "walk visited " + std::to_string(*it) + " twice";
+                        failed.store(true, std::memory_order_release);
+                        return;
+                    }
+                }
+                walks.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+
+    for (int t = 0; t < opts.threads; ++t)
+        th[t].join();
+    stop.store(true, std::memory_order_release);
+    th.back().join();
+    if (failed.load(std::memory_order_acquire))
+        return Fail(opts, failure);
+
+    std::vector<int> in;
+    std::vector<int> out;
+    for (const auto& v : added)
+        in.insert(in.end(), v.begin(), v.end());
+    for (const auto& v : taken)
+        out.insert(out.end(), v.begin(), v.end());
+    const std::size_t left = out.size();
+    for (int v : l)
+        out.push_back(v);
+    if (l.size() != out.size() - left)
+        return Fail(opts, "size() disagrees with a walk");
+
+    std::sort(in.begin(), in.end());
+    std::sort(out.begin(), out.end());
+    if (std::adjacent_find(out.begin(), out.end()) != out.end())
+        return Fail(opts, "an element left the list twice");
+    if (in != out)
+        return Fail(opts,
+                    "elements were lost or invented: " + std::to_string(in.size()) + " added, " +
+                        std::to_string(out.size()) + " accounted for");
+
+    std::cout << "soak        " << opts.threads << "x" << opts.soakOps << " ops, " << walks.load()
+              << " concurrent walks, " << in.size() << " elements accounted for" << std::endl;
+    return true;
+}
+
+// The bench's mixed scenario; the best of a few runs is the least noisy.
+double
+MeasureMixed(const Options& opts)
+{
+    double best = 0;
+    for (int run = 0; run < 3; ++run)
+    {
+        List<int> l;
+        for (int i = 0; i < 10000; ++i)
+            l.push_back(i);
+
+        const int                perThread = opts.benchOps / opts.threads;
+        std::vector<std::thread> th;
+        const auto               start = std::chrono::steady_clock::now();
+        for (int t = 0; t < opts.threads; ++t)
+            th.emplace_back(
+                [&l, perThread]()
+                {
+                    for (int i = 0; i < perThread; ++i)
+                    {
+                        switch (i % 4)
+                        {
+                        case 0:
+                            l.push_back(i);
+                            break;
+                        case 1:
+                            l.pop_front();
+                            break;
+                        case 2:
+                            l.push_front(i);
+                            break;
+                        default:
+                            l.pop_back();
+                            break;
+                        }
+                    }
+                });
+        for (auto& x : th)
+            x.join();
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best                 = std::max(best, static_cast<double>(perThread) * opts.threads / seconds);
+    }
+    return best;
+}
+
+// The baseline file holds one ops/sec figure. It is machine specific, so a
+// missing file is written rather than treated as a failure. A drop below
+// the tolerance is only reported unless the baseline is enforced.
+bool
+RunThroughput(const Options& opts)
+{
+    const double rate = MeasureMixed(opts);
+
+    double baseline = 0;
+    if (std::ifstream in(opts.baseline); in)
+        in >> baseline;
+
+    std::cout << "throughput  mixed, " << opts.threads << " threads: " << std::fixed << std::setprecision(0) << rate
+              << " ops/sec";
+    if (baseline > 0 && !opts.updateBaseline)
+    {
+        std::cout << ", baseline " << baseline << " (" << rate / baseline * 100 << "%)" << std::endl;
+        if (rate >= baseline * (1 - opts.tolerance))
+            return true;
+        if (!opts.enforceBaseline)
+        {
+            std::cout << "            more than " << static_cast<int>(opts.tolerance * 100)
+                      << "% below the baseline; not enforced" << std::endl;
+            return true;
+        }
+        return Fail(opts,
+                    "throughput fell more than " + std::to_string(static_cast<int>(opts.tolerance * 100)) +
+                        "% below the baseline in " + opts.baseline);
+    }
+
+    std::ofstream out(opts.baseline);
+    out << std::fixed << std::setprecision(0) << rate << "\n";
+    std::cout << ", baseline written to " << opts.baseline << std::endl;
+    return true;
+}
+
+Options
+Parse(int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+        const std::size_t      eq  = arg.find('=');
+        const std::string_view key = arg.substr(0, eq);
+        const std::string      value(eq == std::string_view::npos ? "" : arg.substr(eq + 1));
+
+        if (key == "--seed")
+            opts.seed = std::stoull(value);
+        else if (key == "--threads")
+            opts.threads = std::stoi(value);
+        else if (key == "--rounds")
+            opts.rounds = std::stoi(value);
+        else if (key == "--round-ops")
+            opts.roundOps = std::stoi(value);
+        else if (key == "--soak-ops")
+            opts.soakOps = std::stoi(value);
+        else if (key == "--hot-rounds")
+            opts.hotRounds = std::stoi(value);
+        else if (key == "--hot-ops")
+            opts.hotOps = std::stoi(value);
+        else if (key == "--watchdog")
+            opts.watchdog = std::stoi(value);
+        else if (key == "--bench-ops")
+            opts.benchOps = std::stoi(value);
+        else if (key == "--tolerance")
+            opts.tolerance = std::stod(value);
+        else if (key == "--baseline")
+            opts.baseline = value;
+        else if (key == "--update-baseline")
+            opts.updateBaseline = true;
+        else if (key == "--enforce-baseline")
+            opts.enforceBaseline = true;
+        else
+        {
+            std::cerr << "usage: " << argv[0]
+                      << " [--seed=N] [--threads=N] [--rounds=N] [--round-ops=N] [--soak-ops=N]"
+                         " [--hot-rounds=N] [--hot-ops=N] [--watchdog=SECONDS] [--bench-ops=N] [--tolerance=F]"
+                         " [--baseline=PATH] [--update-baseline] [--enforce-baseline]\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    opts.threads  = std::max(opts.threads, 1);
+    opts.watchdog = std::max(opts.watchdog, 1);
+    opts.roundOps = std::clamp(opts.roundOps, 1, 64);
+    return opts;
+}
+}  // namespace
+
+int
+main(int argc, char** argv)
+{
+    const Options opts = Parse(argc, argv);
+    std::cout << "seed " << opts.seed << std::endl;
+
+    if (!RunHistories(opts) || !RunHotFront(opts) || !RunSoak(opts) || !RunThroughput(opts))
+        return EXIT_FAILURE;
+
+    std::cout << "\n=== Stress Passed ===" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+
+// What a trace record describes. Lock and unlock refer to the link of the
+// node recorded with them; begin/end bracket one Node::Insert,
+// Node::Remove or Node::Replace call including all of its retries.
+enum class TraceEvent : std::uint16_t
+{
+    InsertBegin,
+    InsertEnd,
+    RemoveBegin,
+    RemoveEnd,
+    ReplaceBegin,
+    ReplaceEnd,
+    CasFail,
+    LockNext,
+    UnlockNext,
+    LockPrev,
+    UnlockPrev,
+    Yield
+};
+
+// Per-thread rings of timestamped events for offline contention analysis.
+// Only the owning thread writes its ring, so recording is a timestamp read
+// and a few plain stores; once full, a ring overwrites its oldest events.
+// Rings are handed on to new threads when their owner exits and are never
+// freed, so a dump also covers threads that are gone. Dumps read the rings
+// without stopping writers and are meant for quiescent points, e.g. the end
+// of a benchmark run.
+class TraceLog
+{
+public:
+    static constexpr std::size_t kRingSize = std::size_t{1} << 16;
+
+    static TraceLog&
+    Instance()
+    {
+        static TraceLog log;
+        return log;
+    }
+
+    ~TraceLog()
+    {
+        for (Ring* r = m_rings.load(std::memory_order_acquire); r;)
+        {
+            Ring* next = r->next;
+            delete r;
+            r = next;
+        }
+    }
+
+    TraceLog(const TraceLog&) = delete;
+    TraceLog&
+    operator=(const TraceLog&) = delete;
+
+    // `line` names the call site, so retries of different CASes in the same
+    // operation stay apart.
+    static void
+    Record(TraceEvent event, const void* object, std::uint32_t line)
+    {
+        Ring&               ring = Instance().Mine();
+        const std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+        ring.events[head & (kRingSize - 1)] =
+            Entry{Now(), reinterpret_cast<std::uintptr_t>(object), line, event};
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+
+    // Writes every ring as Chrome trace JSON (chrome://tracing, Perfetto).
+    // Operations become slices on their ring's track, held locks become
+    // async slices keyed by link and node, everything else instant events.
+    void
+    WriteChrome(std::ostream& out) const
+    {
+        const double ticksPerMicro = TicksPerMicrosecond();
+        bool         first         = true;
+        out << "{\"traceEvents\":[";
+        for (const Ring* r = m_rings.load(std::memory_order_acquire); r; r = r->next)
+        {
+            const std::uint64_t head  = r->head.load(std::memory_order_acquire);
+            const std::uint64_t begin = head > kRingSize ? head - kRingSize : 0;
+            for (std::uint64_t i = begin; i < head; ++i)
+            {
+                const Entry& e = r->events[i & (kRingSize - 1)];
+                out << (first ? "\n" : ",\n");
+                first = false;
+                WriteEntry(out, e, r->id, static_cast<double>(e.tsc - m_startTsc) / ticksPerMicro);
+            }
+        }
+        out << "\n]}\n";
+    }
+
+    bool
+    WriteChrome(const std::string& path) const
+    {
+        std::ofstream out(path);
+        WriteChrome(out);
+        return static_cast<bool>(out);
+    }
+
+private:
+    struct Entry
+    {
+        std::uint64_t tsc;
+        std::uint64_t object;
+        std::uint32_t line;
+        TraceEvent    event;
+    };
+
+    struct Ring
+    {
+        std::atomic<std::uint64_t> head{0};
+        std::atomic<bool>          inUse{true};
+        Ring*                      next = nullptr;
+        unsigned                   id   = 0;
+        Entry                      events[kRingSize];
+    };
+
+    // Gives the ring back when its thread exits.
+    struct ThreadRing
+    {
+        ~ThreadRing()
+        {
+            if (ring)
+                ring->inUse.store(false, std::memory_order_release);
+        }
+
+        Ring* ring = nullptr;
+    };
+
+    TraceLog()
+        : m_startTsc(Now())
+        , m_startTime(std::chrono::steady_clock::now())
+    {
+    }
+
+    static std::uint64_t
+    Now()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+#endif
+    }
+
+    // calibrated over the lifetime of the log
+    double
+    TicksPerMicrosecond() const
+    {
+        const std::uint64_t ticks = Now() - m_startTsc;
+        const double        micros =
+            std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_startTime).count();
+        return micros > 0 && ticks > 0 ? ticks / micros : 1.0;
+    }
+
+    Ring&
+    Mine()
+    {
+        static thread_local ThreadRing mine;
+        if (!mine.ring)
+            mine.ring = Claim();
+        return *mine.ring;
+    }
+
+    Ring*
+    Claim()
+    {
+        for (Ring* r = m_rings.load(std::memory_order_acquire); r; r = r->next)
+        {
+            bool expected = false;
+            if (!r->inUse.load(std::memory_order_relaxed) &&
+                r->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                return r;
+        }
+
+        Ring* r = new Ring;
+        r->id   = m_ringCount.fetch_add(1, std::memory_order_relaxed) + 1;
+        r->next = m_rings.load(std::memory_order_relaxed);
+        while (!m_rings.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+        return r;
+    }
+
+    static void
+    WriteEntry(std::ostream& out, const Entry& e, unsigned tid, double ts)
+    {
+        static constexpr const char* kNames[]  = {"Insert", "Insert", "Remove", "Remove", "Replace", "Replace",
+                                                  "cas fail", "m_next", "m_next", "m_prev", "m_prev", "yield"};
+        static constexpr const char* kPhases[] = {"B", "E", "B", "E", "B", "E", "i", "b", "e", "b", "e", "i"};
+
+        const auto kind = static_cast<std::size_t>(e.event);
+        out << "{\"name\":\"" << kNames[kind] << "\",\"ph\":\"" << kPhases[kind] << "\",\"pid\":1,\"tid\":" << tid
+            << ",\"ts\":" << std::fixed << ts;
+        switch (e.event)
+        {
+        case TraceEvent::LockNext:
+        case TraceEvent::UnlockNext:
+        case TraceEvent::LockPrev:
+        case TraceEvent::UnlockPrev:
+            out << ",\"cat\":\"" << kNames[kind] << "\",\"id\":\"0x" << std::hex << e.object << std::dec << "\"";
+            break;
+        case TraceEvent::CasFail:
+        case TraceEvent::Yield:
+            out << ",\"s\":\"t\"";
+            break;
+        default:
+            break;
+        }
+        out << ",\"args\":{\"node\":\"0x" << std::hex << e.object << std::dec << "\",\"line\":" << e.line << "}}";
+    }
+
+    const std::uint64_t                         m_startTsc;
+    const std::chrono::steady_clock::time_point m_startTime;
+    std::atomic<Ring*>                          m_rings{nullptr};
+    std::atomic<unsigned>                       m_ringCount{0};
+};
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Chase-Lev style work-stealing deque laid out as a linked chain of nodes.
+// The owning thread pushes and pops at the back without any read-modify-
+// write instruction in the common case; other threads steal() from the front
+// with a CAS on the tagged top word. Owner and thieves only synchronize when
+// they race for the last element.
+//
+// Nodes are recycled for the lifetime of the deque and only freed by the
+// destructor, so a thief that lost a race may still read a stale node's
+// `next` safely; the index half of the top word makes its CAS fail.
+template<typename T>
+class WorkStealingList
+{
+    struct Node
+    {
+        T&
+        data()
+        {
+            return *std::launder(reinterpret_cast<T*>(m_storage));
+        }
+
+        std::atomic<Node*>       m_next{nullptr};
+        Node*                    m_prev = nullptr;  // owner only
+        Node*                    m_free = nullptr;  // free lists
+        alignas(T) unsigned char m_storage[sizeof(T)];
+    };
+
+    struct Top
+    {
+        Node*         ptr;
+        std::uint64_t idx;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Top>);
+
+public:
+    using size_type = std::size_t;
+
+    WorkStealingList()
+    {
+        // m_tail is the empty slot at index `bottom` the next push fills
+        m_tail = NewNode();
+        m_top.store(Top{m_tail, 0}, std::memory_order_relaxed);
+    }
+
+    ~WorkStealingList()
+    {
+        const std::uint64_t b = m_bottom.load(std::memory_order_relaxed);
+        Top                 t = m_top.load(std::memory_order_relaxed);
+        for (Node* n = t.ptr; t.idx < b; ++t.idx, n = n->m_next.load(std::memory_order_relaxed))
+            n->data().~T();
+        for (Node* n : m_nodes)
+            delete n;
+    }
+
+    WorkStealingList(const WorkStealingList&) = delete;
+    WorkStealingList&
+    operator=(const WorkStealingList&) = delete;
+
+    // owner thread only
+    template<typename U>
+    void
+    push_back(U&& value)
+    {
+        // the new tail first: once the value is in the slot, nothing may throw
+        Node* slot = m_tail;
+        Node* tail = NewNode();
+        try
+        {
+            ::new (static_cast<void*>(slot->m_storage)) T(std::forward<U>(value));
+        }
+        catch (...)
+        {
+            Retire(tail);
+            throw;
+        }
+
+        tail->m_prev = slot;
+        slot->m_next.store(tail, std::memory_order_release);
+        m_tail = tail;
+
+        m_bottom.store(m_bottom.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // owner thread only
+    std::optional<T>
+    pop_back()
+    {
+        const std::uint64_t b = m_bottom.load(std::memory_order_relaxed);
+        if (b == 0)
+            return std::nullopt;
+
+        m_bottom.store(b - 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        Top t = m_top.load(std::memory_order_relaxed);
+
+        if (t.idx > b - 1)
+        {
+            m_bottom.store(b, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        Node* slot = m_tail->m_prev;
+        if (t.idx < b - 1)
+        {
+            // thieves cannot reach index b - 1 any more
+            std::optional<T> out(std::move(slot->data()));
+            slot->data().~T();
+            Retire(std::exchange(m_tail, slot));
+            return out;
+        }
+
+        // last element: race the thieves for it
+        std::optional<T> out;
+        if (m_top.compare_exchange_strong(
+                t, Top{m_tail, t.idx + 1}, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            out.emplace(std::move(slot->data()));
+            slot->data().~T();
+            Retire(slot);
+        }
+
+        m_bottom.store(b, std::memory_order_relaxed);
+        return out;
+    }
+
+    // any thread
+    std::optional<T>
+    steal()
+    {
+        Top t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::uint64_t b = m_bottom.load(std::memory_order_acquire);
+        if (t.idx >= b)
+            return std::nullopt;
+
+        Node* next = t.ptr->m_next.load(std::memory_order_acquire);
+        if (!m_top.compare_exchange_strong(
+                t, Top{next, t.idx + 1}, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return std::nullopt;
+
+        std::optional<T> out(std::move(t.ptr->data()));
+        t.ptr->data().~T();
+        GiveBack(t.ptr);
+        return out;
+    }
+
+    size_type
+    size() const
+    {
+        const std::uint64_t b = m_bottom.load(std::memory_order_acquire);
+        const std::uint64_t t = m_top.load(std::memory_order_acquire).idx;
+        return b > t ? static_cast<size_type>(b - t) : 0;
+    }
+
+    bool
+    empty() const
+    {
+        return size() == 0;
+    }
+
+private:
+    Node*
+    NewNode()
+    {
+        if (!m_spare)
+            m_spare = m_stolen.exchange(nullptr, std::memory_order_acquire);
+
+        if (Node* n = m_spare)
+        {
+            m_spare = n->m_free;
+            n->m_next.store(nullptr, std::memory_order_relaxed);
+            return n;
+        }
+
+        auto n = std::make_unique<Node>();
+        m_nodes.push_back(n.get());
+        return n.release();
+    }
+
+    void
+    Retire(Node* n)
+    {
+        n->m_free = m_spare;
+        m_spare   = n;
+    }
+
+    // thieves hand drained nodes back to the owner through a Treiber stack
+    // that the owner empties in one exchange
+    void
+    GiveBack(Node* n)
+    {
+        Node* head = m_stolen.load(std::memory_order_relaxed);
+        do
+        {
+            n->m_free = head;
+        } while (!m_stolen.compare_exchange_weak(head, n, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    alignas(64) std::atomic<Top> m_top;
+    alignas(64) std::atomic<std::uint64_t> m_bottom{0};
+    Node*              m_tail  = nullptr;
+    Node*              m_spare = nullptr;
+    std::vector<Node*> m_nodes;
+    alignas(64) std::atomic<Node*> m_stolen{nullptr};
+};